@@ -0,0 +1,201 @@
+#include <benchmark/benchmark.h>
+#include <Eigen/Dense>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "engine.hpp"
+#include "command_parser.hpp"
+#include "params.hpp"
+#include "wind_field.hpp"
+
+/// Fill engine with objects falling from high altitude, so none of them lands or falls asleep
+/// @return ids of added objects
+static std::vector<int> populate(Engine& engine, int n)
+{
+    std::vector<int> ids;
+    ids.reserve(n);
+    for (int i = 0; i < n; i++)
+    {
+        ids.push_back(engine.addObj(1.0 + i % 7, 0.01, Eigen::Vector3d(i,0.0,-1e6), Eigen::Vector3d(20.0,0.0,0.0)));
+    }
+    return ids;
+}
+
+/// Silences energy logs of collisions for lifetime of object
+struct MuteClog
+{
+    std::streambuf* buf = std::clog.rdbuf(nullptr);
+    ~MuteClog() {std::clog.clear(); std::clog.rdbuf(buf);}
+};
+
+/// Whole simulation step
+static void BM_Tick(benchmark::State& bs)
+{
+    Params params{};
+    Engine engine(params);
+    populate(engine, bs.range(0));
+    engine.step();
+    for (auto _ : bs)
+    {
+        engine.step();
+    }
+    bs.SetItemsProcessed(bs.iterations()*bs.range(0));
+}
+BENCHMARK(BM_Tick)->RangeMultiplier(10)->Range(1, 100000)->Unit(benchmark::kMicrosecond);
+
+/// Simulation step with objects sampling gridded wind field instead of own wind
+static void BM_TickWindField(benchmark::State& bs)
+{
+    WindField::Grid grid;
+    grid.nx = grid.ny = grid.nz = 32;
+    grid.nt = 4;
+    grid.origin = Eigen::Vector3d(0.0,-100.0,-1e6);
+    grid.spacing = Eigen::Vector3d(1e4,10.0,1e4);
+    std::vector<float> wind(3*grid.nx*grid.ny*grid.nz*grid.nt);
+    for (size_t i = 0; i < wind.size(); i++)
+    {
+        wind[i] = static_cast<float>(i % 13) - 6.0f;
+    }
+    Params params{};
+    params.WIND_FIELD = (std::filesystem::temp_directory_path() / "drop_bench_wind.dwf").string();
+    WindField::save(params.WIND_FIELD, grid, wind);
+    Engine engine(params);
+    populate(engine, bs.range(0));
+    engine.step();
+    for (auto _ : bs)
+    {
+        engine.step();
+    }
+    bs.SetItemsProcessed(bs.iterations()*bs.range(0));
+}
+BENCHMARK(BM_TickWindField)->RangeMultiplier(10)->Range(1, 100000)->Unit(benchmark::kMicrosecond);
+
+/// Text state serialization, as published every step
+static void BM_StateToString(benchmark::State& bs)
+{
+    Params params{};
+    Engine engine(params);
+    populate(engine, bs.range(0));
+    engine.step();
+    for (auto _ : bs)
+    {
+        benchmark::DoNotOptimize(engine.getState().to_string());
+    }
+    bs.SetItemsProcessed(bs.iterations()*bs.range(0));
+}
+BENCHMARK(BM_StateToString)->RangeMultiplier(10)->Range(1, 100000)->Unit(benchmark::kMicrosecond);
+
+/// Parse and apply control message, as done by simulation at step boundary
+/// @param makeMsg builds message from ids of existing objects
+/// @param prepare called before every message, e.g. to restore state changed by previous one
+template<typename M, typename P>
+static void parseAndApply(benchmark::State& bs, M makeMsg, P prepare)
+{
+    Params params{};
+    Engine engine(params);
+    const std::string msg = makeMsg(populate(engine, 1000));
+    std::vector<cmd::Command> batch;
+    batch.reserve(16);
+    for (auto _ : bs)
+    {
+        prepare(engine);
+        benchmark::DoNotOptimize(cmd::parse(msg,batch));
+        for(const auto& command: batch)
+        {
+            engine.apply(command);
+        }
+        batch.clear();
+    }
+}
+
+/// Add command is only parsed, applying it would grow state
+static void BM_ParseAdd(benchmark::State& bs)
+{
+    std::vector<cmd::Command> batch;
+    batch.reserve(16);
+    for (auto _ : bs)
+    {
+        benchmark::DoNotOptimize(cmd::parse("a:1.5,0.01,10.0,20.0,-300.0,1.0,2.0,3.0",batch));
+        batch.clear();
+    }
+}
+BENCHMARK(BM_ParseAdd);
+
+static void BM_ParseWind(benchmark::State& bs)
+{
+    parseAndApply(bs, [](const std::vector<int>& ids)
+    {
+        return "w:" + std::to_string(ids[500]) + ",1.0,2.0,0.5;" + std::to_string(ids[501]) + ",-3.0,0.0,0.0";
+    }, [](Engine&) {});
+}
+BENCHMARK(BM_ParseWind);
+
+static void BM_ParseForce(benchmark::State& bs)
+{
+    parseAndApply(bs, [](const std::vector<int>& ids)
+    {
+        return "f:" + std::to_string(ids[500]) + ",2.0,1.0,-0.5";
+    }, [](Engine&) {});
+}
+BENCHMARK(BM_ParseForce);
+
+static void BM_ParseCollision(benchmark::State& bs)
+{
+    MuteClog mute;
+    int id = -1, index = -1;
+    parseAndApply(bs, [&id](const std::vector<int>& ids)
+    {
+        id = ids[500];
+        return "j:" + std::to_string(id) + ",0.5,0.4,0.3,0.0,0.0,-1.0";
+    }, [&](Engine& engine)
+    {
+        // object has to move into surface, otherwise collision is skipped
+        if(index < 0) index = engine.getState().findIndex(id);
+        engine.getState().setVel(index,Eigen::Vector3d(3.0,1.0,8.0));
+    });
+}
+BENCHMARK(BM_ParseCollision);
+
+/// Collision response of object moving into surface
+static void BM_ImpulseForce(benchmark::State& bs)
+{
+    MuteClog mute;
+    Params params{};
+    Engine engine(params);
+    auto ids = populate(engine, 1000);
+    State& state = engine.getState();
+    const int index = state.findIndex(ids[500]);
+    const Eigen::Vector3d vel(3.0,1.0,8.0), normal(0.0,0.0,-1.0);
+    for (auto _ : bs)
+    {
+        state.setVel(index,vel);
+        engine.calcImpulseForce(ids[500], 0.5, 0.4, 0.3, normal);
+    }
+}
+BENCHMARK(BM_ImpulseForce);
+
+/// Objects added and removed every step next to steady population
+static void BM_AddRemoveChurn(benchmark::State& bs)
+{
+    Params params{};
+    Engine engine(params);
+    populate(engine, bs.range(0));
+    const int churn = 16;
+    std::vector<int> added(churn);
+    engine.step();
+    for (auto _ : bs)
+    {
+        for (int i = 0; i < churn; i++)
+        {
+            added[i] = engine.addObj(1.0, 0.01, Eigen::Vector3d(0.0,i,-1e6));
+        }
+        engine.step();
+        for (int id: added)
+        {
+            engine.removeObj(id);
+        }
+    }
+    bs.SetItemsProcessed(bs.iterations()*churn);
+}
+BENCHMARK(BM_AddRemoveChurn)->RangeMultiplier(10)->Range(10, 10000)->Unit(benchmark::kMicrosecond);
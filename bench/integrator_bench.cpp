@@ -0,0 +1,132 @@
+#include <benchmark/benchmark.h>
+#include <Eigen/Dense>
+#include <memory>
+#include <variant>
+#include "fixed_integrator.hpp"
+#include "integrator.hpp"
+#include "force_kernel.hpp"
+#include "common.hpp"
+#include "defines.hpp"
+
+static const int LOOKAHEAD_STEPS = 1000;
+static const double STEP = 0.003;
+
+/// Inputs of single falling object
+static fixed::Inputs objectInputs()
+{
+    return {Eigen::Vector3d(3.0,1.0,0.0), Eigen::Vector3d::Zero(), 2.0, 0.01, def::DEFAULT_AIR_DENSITY};
+}
+
+/// Single object trajectory through ODE::factory, dynamic vector and type erased RHS
+static void BM_LookaheadODE(benchmark::State& bs)
+{
+    auto ode = ODE::factory(ODE::fromString("RK4"));
+    const fixed::Inputs inputs = objectInputs();
+    auto RHS = [&inputs](double, Eigen::VectorXd y)
+    {
+        Eigen::VectorXd res(6);
+        res.head<3>() = y.tail<3>();
+        res.tail<3>() = kernel::acceleration(y.tail<3>(), inputs.wind, inputs.force, inputs.mass, inputs.CS, inputs.airDensity);
+        return res;
+    };
+    for (auto _ : bs)
+    {
+        Eigen::VectorXd y(6);
+        y << 0.0, 0.0, -1000.0, 20.0, 0.0, 0.0;
+        for (int i = 0; i < LOOKAHEAD_STEPS; i++)
+        {
+            y = ode->step(i*STEP, y, RHS, STEP);
+        }
+        benchmark::DoNotOptimize(y.data());
+    }
+    bs.SetItemsProcessed(bs.iterations()*LOOKAHEAD_STEPS);
+}
+BENCHMARK(BM_LookaheadODE);
+
+/// Single object trajectory through fixed step method specialized at compile time
+static void BM_LookaheadFixed(benchmark::State& bs)
+{
+    const fixed::Method method = *fixed::fromString("RK4");
+    const fixed::Inputs inputs = objectInputs();
+    for (auto _ : bs)
+    {
+        fixed::Vector6d y;
+        y << 0.0, 0.0, -1000.0, 20.0, 0.0, 0.0;
+        std::visit([&](const auto& stepper)
+        {
+            for (int i = 0; i < LOOKAHEAD_STEPS; i++)
+            {
+                stepper(y, STEP, [&](const fixed::Vector6d& s) {return fixed::derivative(s,inputs);});
+            }
+        }, method);
+        benchmark::DoNotOptimize(y.data());
+    }
+    bs.SetItemsProcessed(bs.iterations()*LOOKAHEAD_STEPS);
+}
+BENCHMARK(BM_LookaheadFixed);
+
+/// Many objects stepped one by one with fixed step method
+static void BM_SwarmFixed(benchmark::State& bs)
+{
+    const int n = bs.range(0);
+    const fixed::Method method = *fixed::fromString("RK4");
+    const fixed::Inputs inputs = objectInputs();
+    Eigen::VectorXd y = Eigen::VectorXd::Constant(6*n,1.0);
+    for (auto _ : bs)
+    {
+        std::visit([&](const auto& stepper)
+        {
+            for (int i = 0; i < n; i++)
+            {
+                fixed::Vector6d obj = y.segment<6>(6*i);
+                stepper(obj, STEP, [&](const fixed::Vector6d& s) {return fixed::derivative(s,inputs);});
+                y.segment<6>(6*i) = obj;
+            }
+        }, method);
+        benchmark::ClobberMemory();
+    }
+    bs.SetItemsProcessed(bs.iterations()*n);
+}
+BENCHMARK(BM_SwarmFixed)->RangeMultiplier(8)->Range(8, 1 << 15);
+
+/// Many objects stepped together by in place integrator with batched force kernel
+static void BM_SwarmBatched(benchmark::State& bs)
+{
+    const int n = bs.range(0);
+    const fixed::Inputs inputs = objectInputs();
+    Integrator integrator("RK4");
+    kernel::ForceBatch batch;
+    batch.reserve(n);
+    for (int i = 0; i < n; i++)
+    {
+        batch.wx[i] = inputs.wind.x(); batch.wy[i] = inputs.wind.y(); batch.wz[i] = inputs.wind.z();
+        batch.fx[i] = 0.0; batch.fy[i] = 0.0; batch.fz[i] = 0.0;
+        batch.mass[i] = inputs.mass;
+        batch.CS[i] = inputs.CS;
+    }
+    auto rhs = [&](double, const Eigen::Ref<const Eigen::VectorXd>& y, Eigen::Ref<Eigen::VectorXd> dydt)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            batch.vx[i] = y(3+6*i);
+            batch.vy[i] = y(4+6*i);
+            batch.vz[i] = y(5+6*i);
+            dydt.segment<3>(6*i) = y.segment<3>(3+6*i);
+        }
+        kernel::accelerations(batch,n,inputs.airDensity);
+        for (int i = 0; i < n; i++)
+        {
+            dydt(3+6*i) = batch.ax[i];
+            dydt(4+6*i) = batch.ay[i];
+            dydt(5+6*i) = batch.az[i];
+        }
+    };
+    Eigen::VectorXd y = Eigen::VectorXd::Constant(6*n,1.0);
+    for (auto _ : bs)
+    {
+        integrator.step(0.0, y, STEP, rhs);
+        benchmark::ClobberMemory();
+    }
+    bs.SetItemsProcessed(bs.iterations()*n);
+}
+BENCHMARK(BM_SwarmBatched)->RangeMultiplier(8)->Range(8, 1 << 15);
@@ -0,0 +1,100 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "force_kernel.hpp"
+#include "atmosphere.hpp"
+#include "defines.hpp"
+
+/// Fill batch with moving objects
+static void fillBatch(kernel::ForceBatch& batch, int n)
+{
+    batch.reserve(n);
+    for (int i = 0; i < n; i++)
+    {
+        batch.vx[i] = 0.1*i; batch.vy[i] = 1.0; batch.vz[i] = 20.0;
+        batch.wx[i] = 3.0; batch.wy[i] = 0.0; batch.wz[i] = 0.0;
+        batch.fx[i] = 0.0; batch.fy[i] = 0.0; batch.fz[i] = 0.0;
+        batch.mass[i] = 1.0 + i % 7;
+        batch.CS[i] = 0.01;
+    }
+}
+
+/// Portable force kernel over batch of objects
+static void BM_ForceKernelScalar(benchmark::State& bs)
+{
+    kernel::ForceBatch batch;
+    const int n = bs.range(0);
+    fillBatch(batch,n);
+    for (auto _ : bs)
+    {
+        kernel::accelerationsScalar(batch,n,def::DEFAULT_AIR_DENSITY);
+        benchmark::ClobberMemory();
+    }
+    bs.SetItemsProcessed(bs.iterations()*n);
+}
+BENCHMARK(BM_ForceKernelScalar)->RangeMultiplier(8)->Range(8, 1 << 15);
+
+/// AVX2 force kernel over batch of objects
+static void BM_ForceKernelAVX2(benchmark::State& bs)
+{
+    if(!kernel::hasAVX2())
+    {
+        bs.SkipWithError("CPU does not support AVX2");
+        return;
+    }
+    kernel::ForceBatch batch;
+    const int n = bs.range(0);
+    fillBatch(batch,n);
+    for (auto _ : bs)
+    {
+        kernel::accelerationsAVX2(batch,n,def::DEFAULT_AIR_DENSITY);
+        benchmark::ClobberMemory();
+    }
+    bs.SetItemsProcessed(bs.iterations()*n);
+}
+BENCHMARK(BM_ForceKernelAVX2)->RangeMultiplier(8)->Range(8, 1 << 15);
+
+
+/// Altitudes spread over whole atmosphere table
+static std::vector<double> altitudes(int n)
+{
+    std::vector<double> altitude(n);
+    for (int i = 0; i < n; i++)
+    {
+        altitude[i] = (i*7919) % 80000;
+    }
+    return altitude;
+}
+
+/// Density of batch of objects from ISA tables, as done on every RHS evaluation. Compare with force kernels
+static void BM_AtmosphereTable(benchmark::State& bs)
+{
+    Atmosphere atmosphere("ISA");
+    const int n = bs.range(0);
+    const std::vector<double> altitude = altitudes(n);
+    std::vector<double> rho(n);
+    for (auto _ : bs)
+    {
+        atmosphere.densities(altitude.data(),rho.data(),n);
+        benchmark::ClobberMemory();
+    }
+    bs.SetItemsProcessed(bs.iterations()*n);
+}
+BENCHMARK(BM_AtmosphereTable)->RangeMultiplier(8)->Range(8, 1 << 15);
+
+/// Density of batch of objects from analytic ISA formulas
+static void BM_AtmosphereAnalytic(benchmark::State& bs)
+{
+    const int n = bs.range(0);
+    const std::vector<double> altitude = altitudes(n);
+    std::vector<double> rho(n);
+    for (auto _ : bs)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            rho[i] = isa::density(altitude[i]);
+        }
+        benchmark::ClobberMemory();
+    }
+    bs.SetItemsProcessed(bs.iterations()*n);
+}
+BENCHMARK(BM_AtmosphereAnalytic)->RangeMultiplier(8)->Range(8, 1 << 15);
@@ -0,0 +1,80 @@
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+#include "command_parser.hpp"
+
+/// Parse single message repeatedly, without applying it
+static void parseOnly(benchmark::State& bs, const std::string& msg)
+{
+    std::vector<cmd::Command> batch;
+    batch.reserve(256);
+    for (auto _ : bs)
+    {
+        benchmark::DoNotOptimize(cmd::parseCommand(msg,batch));
+        batch.clear();
+    }
+    bs.SetBytesProcessed(bs.iterations()*msg.size());
+}
+
+static void BM_ParseCommandAdd(benchmark::State& bs)
+{
+    parseOnly(bs, "a:1.5,0.01,10.0,20.0,-300.0,1.0,2.0,3.0");
+}
+BENCHMARK(BM_ParseCommandAdd);
+
+static void BM_ParseCommandRemove(benchmark::State& bs)
+{
+    parseOnly(bs, "r:1234");
+}
+BENCHMARK(BM_ParseCommandRemove);
+
+static void BM_ParseCommandForce(benchmark::State& bs)
+{
+    parseOnly(bs, "f:1234,2.0,1.0,-0.5");
+}
+BENCHMARK(BM_ParseCommandForce);
+
+static void BM_ParseCommandCollision(benchmark::State& bs)
+{
+    parseOnly(bs, "j:1234,0.5,0.4,0.3,0.0,0.0,-1.0");
+}
+BENCHMARK(BM_ParseCommandCollision);
+
+/// Wind message updating many objects at once, as sent by wind field streams
+static void BM_ParseCommandWind(benchmark::State& bs)
+{
+    std::string msg = "w:";
+    for (int i = 0; i < bs.range(0); i++)
+    {
+        if(i > 0) msg += ';';
+        msg += std::to_string(i) + ",1.25,-3.5,0.125";
+    }
+    parseOnly(bs, msg);
+    bs.SetItemsProcessed(bs.iterations()*bs.range(0));
+}
+BENCHMARK(BM_ParseCommandWind)->RangeMultiplier(4)->Range(1, 256);
+
+/// Rejected message
+static void BM_ParseInvalid(benchmark::State& bs)
+{
+    std::vector<cmd::Command> batch;
+    for (auto _ : bs)
+    {
+        benchmark::DoNotOptimize(cmd::parseCommand("f:1234,2.0,x,-0.5",batch));
+    }
+}
+BENCHMARK(BM_ParseInvalid);
+
+/// Batch of mixed messages with per item replies
+static void BM_ParseBatch(benchmark::State& bs)
+{
+    const std::string msg = "b:f:1,2.0,1.0,-0.5\nw:1,1.0,2.0,0.5;2,-3.0,0.0,0.0\nj:3,0.5,0.4,0.3,0.0,0.0,-1.0\nr:4";
+    std::vector<cmd::Command> batch;
+    batch.reserve(16);
+    for (auto _ : bs)
+    {
+        benchmark::DoNotOptimize(cmd::parseBatch(msg,batch));
+        batch.clear();
+    }
+}
+BENCHMARK(BM_ParseBatch);
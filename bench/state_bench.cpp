@@ -0,0 +1,138 @@
+#include <benchmark/benchmark.h>
+#include <Eigen/Dense>
+#include <vector>
+#include "state.hpp"
+#include "params.hpp"
+#include "shm_publisher.hpp"
+#include "topic_publisher.hpp"
+#include "output_streams.hpp"
+#include "defines.hpp"
+
+/// Fill state with given number of objects
+/// @return ids of added objects
+static std::vector<int> populate(State& state, int n)
+{
+    std::vector<int> ids;
+    ids.reserve(n);
+    for (int i = 0; i < n; i++)
+    {
+        ids.push_back(state.addObj(1.0,0.01,Eigen::Vector3d(i,0.0,0.0)));
+    }
+    return ids;
+}
+
+/// Cost of single id to index lookup. Should stay flat as object count grows
+static void BM_FindIndex(benchmark::State& bs)
+{
+    Params params{};
+    State state;
+    auto ids = populate(state, bs.range(0));
+    size_t i = 0;
+    for (auto _ : bs)
+    {
+        benchmark::DoNotOptimize(state.findIndex(ids[i]));
+        i = (i + 7919) % ids.size();
+    }
+}
+BENCHMARK(BM_FindIndex)->RangeMultiplier(4)->Range(16, 1 << 14);
+
+/// Cost of per object wind update, as done by w: command
+static void BM_UpdateWind(benchmark::State& bs)
+{
+    Params params{};
+    State state;
+    auto ids = populate(state, bs.range(0));
+    size_t i = 0;
+    const Eigen::Vector3d wind(1.0,2.0,0.0);
+    for (auto _ : bs)
+    {
+        state.updateWind(ids[i],wind);
+        i = (i + 7919) % ids.size();
+    }
+}
+BENCHMARK(BM_UpdateWind)->RangeMultiplier(4)->Range(16, 1 << 14);
+
+
+/// Binary frame serialization into reused buffer, as done before publishing over ZMQ
+static void BM_StateToFrame(benchmark::State& bs)
+{
+    Params params{};
+    State state;
+    populate(state, bs.range(0));
+    std::vector<char> frame;
+    for (auto _ : bs)
+    {
+        state.to_frame(frame);
+        benchmark::ClobberMemory();
+    }
+    bs.SetItemsProcessed(bs.iterations()*bs.range(0));
+}
+BENCHMARK(BM_StateToFrame)->RangeMultiplier(8)->Range(8, 1 << 15);
+
+/// Binary frame serialization straight into shared memory ring slot, all that local readers cost writer
+static void BM_ShmPublish(benchmark::State& bs)
+{
+    Params params{};
+    State state;
+    populate(state, bs.range(0));
+    ShmPublisher ring;
+    if(!ring.create("/drop_bench_ring", def::SHM_RING_SLOTS, bs.range(0)))
+    {
+        bs.SkipWithError("Can not create shared memory ring");
+        return;
+    }
+    for (auto _ : bs)
+    {
+        ring.publish(state);
+    }
+    bs.SetItemsProcessed(bs.iterations()*bs.range(0));
+}
+BENCHMARK(BM_ShmPublish)->RangeMultiplier(8)->Range(8, 1 << 15);
+
+/// Topic messages of swarm where tenth of objects moves, arg 1 selects delta mode. Compare bytes per tick
+static void BM_TopicUpdate(benchmark::State& bs)
+{
+    Params params{};
+    State state;
+    const int n = bs.range(0);
+    populate(state, n);
+    TopicPublisher topics("near,0,-1,-1,100,1,1", bs.range(1) ? 0.01 : 0.0);
+    topics.update(state);
+    size_t bytes = 0;
+    for (auto _ : bs)
+    {
+        for (int i = 0; i < n; i += 10)
+        {
+            state.setVel(i, state.getVel(i) + Eigen::Vector3d(0.1,0.0,0.0));
+        }
+        state.tick++;
+        topics.update(state);
+        for (size_t i = 0; i < topics.size(); i++)
+        {
+            bytes += topics.at(i).topic.size() + topics.at(i).payload.size();
+        }
+    }
+    bs.SetItemsProcessed(bs.iterations()*n);
+    bs.counters["bytes_per_tick"] = benchmark::Counter(bytes, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_TopicUpdate)->ArgsProduct({{64, 4096, 1 << 15}, {0, 1}});
+
+/// Per step cost of output streams at 3 ms step: full rate text stream alone, and with 30 Hz text and 1 Hz binary
+/// streams added. Decimated streams serialize only when due, so they should add little
+static void BM_OutputStreams(benchmark::State& bs)
+{
+    Params params{};
+    params.STREAMS = bs.range(1) ? "full:text:0;ui:text:30;log:binary:1" : "full:text:0";
+    State state;
+    const int n = bs.range(0);
+    populate(state, n);
+    OutputStreams streams(params);
+    for (auto _ : bs)
+    {
+        state.tick++;
+        state.real_time += 0.003;
+        benchmark::DoNotOptimize(streams.update(state));
+    }
+    bs.SetItemsProcessed(bs.iterations()*n);
+}
+BENCHMARK(BM_OutputStreams)->ArgsProduct({{64, 4096}, {0, 1}});
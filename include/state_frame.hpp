@@ -0,0 +1,105 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+/// @brief Binary state frame published by drop on state_bin endpoint.
+/// Frame is a Header followed by Header::count Records, all little endian, without padding between them.
+/// Header only, consumers can include it without linking anything.
+namespace drop_frame
+{
+    /// @brief "DROP" in little endian
+    constexpr uint32_t MAGIC = 0x504F5244;
+    /// @brief Current frame format version
+    constexpr uint16_t VERSION = 1;
+    /// @brief Record flag: object rests and is published only from time to time
+    constexpr uint32_t FLAG_SLEEPING = 1;
+
+#pragma pack(push, 1)
+    /// @brief Frame header
+    struct Header
+    {
+        /// @brief always MAGIC
+        uint32_t magic;
+        /// @brief format version
+        uint16_t version;
+        /// @brief size of header in bytes, records start right after it
+        uint16_t headerSize;
+        /// @brief number of records
+        uint32_t count;
+        /// @brief size of single record in bytes
+        uint32_t recordSize;
+        /// @brief simulation step number
+        uint64_t tick;
+        /// @brief simulation time in s
+        double time;
+    };
+
+    /// @brief Single object state
+    struct Record
+    {
+        /// @brief object id
+        int32_t id;
+        /// @brief bit set of FLAG_* values, other bits are 0
+        uint32_t flags;
+        /// @brief position in m
+        double pos[3];
+        /// @brief velocity in m/s
+        double vel[3];
+    };
+#pragma pack(pop)
+
+    static_assert(sizeof(Header) == 32, "Unexpected header size");
+    static_assert(sizeof(Record) == 56, "Unexpected record size");
+
+    /// @brief Size of frame with given number of records
+    /// @param count number of records
+    /// @return size in bytes
+    constexpr size_t frameSize(size_t count) {return sizeof(Header) + count*sizeof(Record);}
+
+    /// @brief Read only view of received frame. Does not copy frame data
+    class FrameReader
+    {
+        public:
+            /// @brief Validate frame
+            /// @param data pointer to frame, must outlive reader
+            /// @param size size of frame in bytes
+            /// @return true if frame is valid and supported
+            bool parse(const void* data, size_t size)
+            {
+                _data = static_cast<const unsigned char*>(data);
+                _valid = false;
+                if(size < sizeof(Header)) return false;
+                std::memcpy(&_header, _data, sizeof(Header));
+                if(_header.magic != MAGIC || _header.version != VERSION) return false;
+                if(_header.headerSize < sizeof(Header) || _header.recordSize < sizeof(Record)) return false;
+                if(size < _header.headerSize + static_cast<size_t>(_header.count)*_header.recordSize) return false;
+                _valid = true;
+                return true;
+            }
+
+            /// @brief Check if last parsed frame was valid
+            inline bool valid() const {return _valid;}
+
+            /// @brief Get frame header
+            inline const Header& header() const {return _header;}
+
+            /// @brief Get number of objects in frame
+            inline size_t size() const {return _valid ? _header.count : 0;}
+
+            /// @brief Get object record
+            /// @param i record index, must be lower than size()
+            /// @return copy of record
+            inline Record at(size_t i) const
+            {
+                Record r;
+                std::memcpy(&r, _data + _header.headerSize + i*_header.recordSize, sizeof(Record));
+                return r;
+            }
+
+        private:
+            const unsigned char* _data = nullptr;
+            Header _header{};
+            bool _valid = false;
+    };
+} // namespace drop_frame
@@ -0,0 +1,225 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "state_frame.hpp"
+
+/// @brief Shared memory ring of binary state frames, for consumers running on the same host as drop.
+/// Ring is a Header followed by Header::slots slots of Header::slotSize bytes. Slot is a Slot followed by
+/// one frame described in state_frame.hpp. Frame n (counted from 1) is written to slot n % slots.
+/// Slot sequence is 2n-1 while frame n is written and 2n when it is complete, so readers detect frames
+/// overwritten while they were read. Writer never waits for readers, readers never block writer.
+/// Header only, consumers can include it without linking anything
+namespace drop_ring
+{
+    /// @brief "RING" in little endian
+    constexpr uint32_t MAGIC = 0x474E4952;
+    /// @brief Current ring format version
+    constexpr uint16_t VERSION = 1;
+    /// @brief Alignment of slots in bytes
+    constexpr size_t ALIGNMENT = 64;
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "Ring needs lock free 64 bit atomics");
+
+    /// @brief Ring header
+    struct alignas(ALIGNMENT) Header
+    {
+        /// @brief always MAGIC
+        uint32_t magic;
+        /// @brief format version
+        uint16_t version;
+        /// @brief size of header in bytes, slots start right after it
+        uint16_t headerSize;
+        /// @brief number of slots
+        uint32_t slots;
+        /// @brief size of slot in bytes, including Slot
+        uint32_t slotSize;
+        /// @brief number of last complete frame, 0 before first frame
+        std::atomic<uint64_t> written;
+        /// @brief number of frames not published because they did not fit into slot
+        std::atomic<uint64_t> oversized;
+    };
+
+    /// @brief Slot header
+    struct alignas(ALIGNMENT) Slot
+    {
+        /// @brief 2n-1 while frame n is written, 2n when it is complete
+        std::atomic<uint64_t> seq;
+        /// @brief size of frame in bytes
+        uint64_t size;
+    };
+
+    /// @brief Size of slot able to hold frame of given number of objects
+    /// @param objects maximal number of records in frame
+    /// @return slot size in bytes
+    constexpr size_t slotSize(size_t objects)
+    {
+        return (sizeof(Slot) + drop_frame::frameSize(objects) + ALIGNMENT - 1)/ALIGNMENT*ALIGNMENT;
+    }
+
+    /// @brief Size of whole ring
+    /// @param slots number of slots
+    /// @param slotSize size of slot in bytes
+    /// @return ring size in bytes
+    constexpr size_t ringSize(size_t slots, size_t slotSize) {return sizeof(Header) + slots*slotSize;}
+
+    /// @brief Read only view of ring in shared memory. Frames are parsed in place, without copies.
+    /// Frame data may be overwritten by writer while it is used, so reader should check intact()
+    /// after it processed frame and drop results if it returns false
+    class Reader
+    {
+        public:
+            /// @brief Result of reading frame
+            enum class Result
+            {
+                /// @brief frame was read
+                ok,
+                /// @brief there is no new frame
+                empty,
+                /// @brief reader was too slow, some frames were overwritten before they were read.
+                /// Latest frame was read instead
+                overrun
+            };
+
+            Reader() = default;
+            Reader(const Reader&) = delete; // no copies
+            Reader& operator=(const Reader&) = delete; // no self-assignments
+
+            /// @brief Deconstructor. Unmaps ring
+            ~Reader() {close();}
+
+            /// @brief Map ring created by drop
+            /// @param name shared memory object name, e.g. "/drop_shot_state"
+            /// @return false if ring does not exist or has unsupported format
+            bool open(const std::string& name)
+            {
+                close();
+                int fd = shm_open(name.c_str(), O_RDONLY, 0);
+                if(fd < 0) return false;
+                struct stat st;
+                if(fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(Header))
+                {
+                    void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+                    if(data != MAP_FAILED)
+                    {
+                        mapping = data;
+                        bytes = st.st_size;
+                    }
+                }
+                ::close(fd);
+                if(mapping == nullptr) return false;
+                header = static_cast<const Header*>(mapping);
+                if(header->magic != MAGIC || header->version != VERSION || header->slots == 0
+                    || header->slotSize < slotSize(0)
+                    || bytes < header->headerSize + static_cast<size_t>(header->slots)*header->slotSize)
+                {
+                    close();
+                    return false;
+                }
+                cursor = latest();
+                skipped = 0;
+                return true;
+            }
+
+            /// @brief Unmap ring
+            void close()
+            {
+                if(mapping != nullptr) munmap(mapping, bytes);
+                mapping = nullptr;
+                header = nullptr;
+                bytes = 0;
+            }
+
+            /// @brief Check if ring is mapped
+            inline bool isOpen() const {return header != nullptr;}
+
+            /// @brief Get number of last complete frame
+            /// @return frame number, 0 if nothing was written yet
+            inline uint64_t latest() const {return header->written.load(std::memory_order_acquire);}
+
+            /// @brief Parse frame n in place
+            /// @param n frame number
+            /// @param frame output, valid only while intact(n) is true
+            /// @return ok, empty if frame was not written yet, overrun if it was already overwritten
+            Result read(uint64_t n, drop_frame::FrameReader& frame) const
+            {
+                const Slot* s = slot(n);
+                const uint64_t seq = s->seq.load(std::memory_order_acquire);
+                if(seq < 2*n) return Result::empty;
+                if(seq != 2*n) return Result::overrun;
+                const uint64_t size = s->size;
+                if(size > header->slotSize - sizeof(Slot) || !frame.parse(s + 1, size)) return Result::overrun;
+                return intact(n) ? Result::ok : Result::overrun;
+            }
+
+            /// @brief Check that frame n was not overwritten since it was read. Call it after frame was processed
+            /// @param n frame number
+            /// @return true if data read from frame are consistent
+            inline bool intact(uint64_t n) const
+            {
+                std::atomic_thread_fence(std::memory_order_acquire);
+                return slot(n)->seq.load(std::memory_order_relaxed) == 2*n;
+            }
+
+            /// @brief Parse frame following the one read last time, for consumers that need every frame.
+            /// Reader that fell behind by more than ring length skips to latest frame
+            /// @param frame output, valid only while intact(current()) is true
+            /// @return ok, empty if there is no new frame, overrun if frames were skipped
+            Result next(drop_frame::FrameReader& frame)
+            {
+                const uint64_t last = latest();
+                if(last <= cursor) return Result::empty;
+                uint64_t n = cursor + 1;
+                Result result = Result::ok;
+                if(last - n >= header->slots || read(n, frame) != Result::ok)
+                {
+                    // wanted frame is gone, take the newest one, it is overwritten last
+                    n = last;
+                    result = Result::overrun;
+                    if(read(n, frame) != Result::ok) return Result::overrun;
+                }
+                skipped += n - cursor - 1;
+                cursor = n;
+                return result;
+            }
+
+            /// @brief Parse latest frame, for consumers that need only current state
+            /// @param frame output, valid only while intact(current()) is true
+            /// @return ok, or empty if nothing was written yet or frame was overwritten meanwhile
+            Result readLatest(drop_frame::FrameReader& frame)
+            {
+                const uint64_t last = latest();
+                if(last == 0 || read(last, frame) != Result::ok) return Result::empty;
+                skipped += last > cursor ? last - cursor - 1 : 0;
+                cursor = last;
+                return Result::ok;
+            }
+
+            /// @brief Get number of frame read last time
+            inline uint64_t current() const {return cursor;}
+
+            /// @brief Get number of frames skipped by next() and latest() since open
+            inline uint64_t lost() const {return skipped;}
+
+            /// @brief Get number of frames writer could not publish because they were larger than slot
+            inline uint64_t oversized() const {return header->oversized.load(std::memory_order_relaxed);}
+
+        private:
+            void* mapping = nullptr;
+            size_t bytes = 0;
+            const Header* header = nullptr;
+            uint64_t cursor = 0;
+            uint64_t skipped = 0;
+
+            inline const Slot* slot(uint64_t n) const
+            {
+                const char* base = static_cast<const char*>(mapping) + header->headerSize;
+                return reinterpret_cast<const Slot*>(base + (n % header->slots)*header->slotSize);
+            }
+    };
+} // namespace drop_ring
@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <cmath>
+#include "adaptive_integrator.hpp"
+#include "defines.hpp"
+
+namespace
+{
+    // Dormand-Prince 5(4) tableau
+    constexpr double c2 = 1.0/5.0, c3 = 3.0/10.0, c4 = 4.0/5.0, c5 = 8.0/9.0;
+    constexpr double a21 = 1.0/5.0;
+    constexpr double a31 = 3.0/40.0, a32 = 9.0/40.0;
+    constexpr double a41 = 44.0/45.0, a42 = -56.0/15.0, a43 = 32.0/9.0;
+    constexpr double a51 = 19372.0/6561.0, a52 = -25360.0/2187.0, a53 = 64448.0/6561.0, a54 = -212.0/729.0;
+    constexpr double a61 = 9017.0/3168.0, a62 = -355.0/33.0, a63 = 46732.0/5247.0, a64 = 49.0/176.0,
+        a65 = -5103.0/18656.0;
+    constexpr double a71 = 35.0/384.0, a73 = 500.0/1113.0, a74 = 125.0/192.0, a75 = -2187.0/6784.0,
+        a76 = 11.0/84.0;
+    constexpr double e1 = 71.0/57600.0, e3 = -71.0/16695.0, e4 = 71.0/1920.0, e5 = -17253.0/339200.0,
+        e6 = 22.0/525.0, e7 = -1.0/40.0;
+    // dense output
+    constexpr double d1 = -12715105075.0/11282082432.0, d3 = 87487479700.0/32700410799.0,
+        d4 = -10690763975.0/1880347072.0, d5 = 701980252875.0/199316789632.0,
+        d6 = -1453857185.0/822651844.0, d7 = 69997945.0/29380423.0;
+}
+
+AdaptiveIntegrator::AdaptiveIntegrator(const std::string& method, const Atmosphere& atmosphere)
+    : _valid{method == "DOPRI5"}, atmosphere{atmosphere}, evaluations{0}, forcedSteps{0}
+{
+}
+
+void AdaptiveIntegrator::reserve(int capacity)
+{
+    if(static_cast<int>(tracks.size()) < capacity) tracks.resize(capacity);
+}
+
+AdaptiveIntegrator::Vector6d AdaptiveIntegrator::rhs(const Vector6d& y, const kernel::ForceBatch& in, int i)
+{
+    evaluations++;
+    Vector6d dydt;
+    dydt.head<3>() = y.tail<3>();
+    dydt.tail<3>() = kernel::acceleration(y.tail<3>(), {in.wx[i],in.wy[i],in.wz[i]},
+        {in.fx[i],in.fy[i],in.fz[i]}, in.mass[i], in.CS[i], atmosphere.density(-y(2)));
+    return dydt;
+}
+
+void AdaptiveIntegrator::restart(Track& track, int id, const Vector6d& y, double t, double h,
+    const kernel::ForceBatch& in, int i)
+{
+    if(track.id != id) track.h = h;
+    track.id = id;
+    track.t = t;
+    track.y = y;
+    track.f = rhs(y, in, i);
+    track.t0 = t;
+    track.hLast = 0.0;
+    track.wind = Eigen::Vector3d(in.wx[i],in.wy[i],in.wz[i]);
+    track.force = Eigen::Vector3d(in.fx[i],in.fy[i],in.fz[i]);
+}
+
+void AdaptiveIntegrator::advance(Track& tr, double T, double maxStep, const kernel::ForceBatch& in, int i)
+{
+    while(tr.t < T)
+    {
+        const double h = std::min(tr.h, maxStep);
+        const Vector6d& y = tr.y;
+        const Vector6d& k1 = tr.f;
+        const Vector6d k2 = rhs(y + h*(a21*k1), in, i);
+        const Vector6d k3 = rhs(y + h*(a31*k1 + a32*k2), in, i);
+        const Vector6d k4 = rhs(y + h*(a41*k1 + a42*k2 + a43*k3), in, i);
+        const Vector6d k5 = rhs(y + h*(a51*k1 + a52*k2 + a53*k3 + a54*k4), in, i);
+        const Vector6d k6 = rhs(y + h*(a61*k1 + a62*k2 + a63*k3 + a64*k4 + a65*k5), in, i);
+        const Vector6d y1 = y + h*(a71*k1 + a73*k3 + a74*k4 + a75*k5 + a76*k6);
+        const Vector6d k7 = rhs(y1, in, i);
+        const Vector6d err = h*(e1*k1 + e3*k3 + e4*k4 + e5*k5 + e6*k6 + e7*k7);
+        const Vector6d scale = (def::ADAPTIVE_ATOL + def::ADAPTIVE_RTOL*y.cwiseAbs().cwiseMax(y1.cwiseAbs()).array()).matrix();
+        const double norm = std::sqrt((err.array()/scale.array()).square().mean());
+        const double factor = norm == 0.0 ? 5.0 : std::clamp(0.9*std::pow(norm,-0.2), 0.2, 5.0);
+        // not finite error, e.g. from NaN state or force, is not reduced by shorter step,
+        // so it is accepted like error of the shortest step, to keep step time bounded
+        const bool finite = std::isfinite(norm);
+        if(finite && norm > 1.0 && h > def::ADAPTIVE_MIN_STEP)
+        {
+            tr.h = std::max(h*std::min(1.0,factor), def::ADAPTIVE_MIN_STEP);
+            continue;
+        }
+        if(!finite || norm > 1.0) forcedSteps++;
+        tr.dense[0] = y;
+        tr.dense[1] = y1 - y;
+        tr.dense[2] = h*k1 - tr.dense[1];
+        tr.dense[3] = tr.dense[1] - h*k7 - tr.dense[2];
+        tr.dense[4] = h*(d1*k1 + d3*k3 + d4*k4 + d5*k5 + d6*k6 + d7*k7);
+        tr.t0 = tr.t;
+        tr.hLast = h;
+        tr.t += h;
+        tr.y = y1;
+        tr.f = k7;
+        tr.h = finite ? std::max(h*factor, def::ADAPTIVE_MIN_STEP) : h;
+    }
+}
+
+void AdaptiveIntegrator::step(State& state, const kernel::ForceBatch& in, double t, double h)
+{
+    const double T = t + h;
+    const double eps = 1e-9*h;
+    for (int i = 0; i < state.getNoAwake(); i++)
+    {
+        const ObjParams* p = state.getParams(i);
+        Track& tr = tracks[i];
+        auto view = state.getStateView();
+        Eigen::Ref<Vector6d> current = view.segment<6>(6*i);
+        if(tr.id != p->id || current != tr.published
+            || tr.wind != Eigen::Vector3d(in.wx[i],in.wy[i],in.wz[i])
+            || tr.force != Eigen::Vector3d(in.fx[i],in.fy[i],in.fz[i]))
+        {
+            restart(tr, p->id, current, t, h, in, i);
+        }
+        advance(tr, T - eps, def::ADAPTIVE_MAX_STEP, in, i);
+        if(tr.t <= T + eps || tr.hLast == 0.0)
+        {
+            current = tr.y;
+        }
+        else
+        {
+            const double theta = (T - tr.t0)/tr.hLast;
+            const double theta1 = 1.0 - theta;
+            current = tr.dense[0] + theta*(tr.dense[1] + theta1*(tr.dense[2] + theta*(tr.dense[3] + theta1*tr.dense[4])));
+        }
+        tr.published = current;
+    }
+}
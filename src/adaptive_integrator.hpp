@@ -0,0 +1,71 @@
+#pragma once
+#include <Eigen/Dense>
+#include <array>
+#include <string>
+#include <vector>
+#include "state.hpp"
+#include "force_kernel.hpp"
+#include "atmosphere.hpp"
+
+/// @brief Dormand-Prince 5(4) integrator with separate error controlled step for every object.
+/// Objects do not interact, so each of them takes as long steps as its own trajectory allows.
+/// Steps may end after the end of simulation step; state at simulation step is then taken from
+/// dense output of the last accepted step. Object is restarted from its current state when its
+/// state is changed from outside (e.g. collision) or when its wind or outer force changes.
+class AdaptiveIntegrator
+{
+    public:
+        /// @brief state of single object
+        using Vector6d = Eigen::Matrix<double,6,1>;
+
+        /// @brief Constructor
+        /// @param method name of ODE method. Only "DOPRI5" is supported
+        /// @param atmosphere air density model, has to outlive integrator
+        AdaptiveIntegrator(const std::string& method, const Atmosphere& atmosphere);
+
+        /// @brief Check if method is supported by adaptive integrator
+        /// @return true if method is known
+        inline bool valid() const {return _valid;}
+
+        /// @brief Preallocate per object data
+        /// @param capacity maximal number of objects
+        void reserve(int capacity);
+
+        /// @brief Move all awake objects from time t to t + h
+        /// @param state simulation state, updated in place
+        /// @param inputs wind, outer forces, masses and CS of objects captured for this step
+        /// @param t time at the beginning of step
+        /// @param h step time
+        void step(State& state, const kernel::ForceBatch& inputs, double t, double h);
+
+        /// @brief Get number of RHS evaluations done so far, for all objects
+        inline long getEvaluations() const {return evaluations;}
+
+        /// @brief Get number of steps accepted without meeting tolerance, because step reached def::ADAPTIVE_MIN_STEP
+        /// or error was not finite, e.g. for NaN force
+        inline long getForcedSteps() const {return forcedSteps;}
+
+    private:
+        struct Track
+        {
+            int id = -1;
+            double t = 0.0;
+            double h = 0.0;
+            Vector6d y, f;
+            double t0 = 0.0, hLast = 0.0;
+            std::array<Vector6d,5> dense;
+            Eigen::Vector3d wind, force;
+            Vector6d published;
+        };
+
+        bool _valid;
+        const Atmosphere& atmosphere;
+        std::vector<Track> tracks;
+        long evaluations;
+        long forcedSteps;
+
+        void restart(Track& track, int id, const Vector6d& y, double t, double h,
+            const kernel::ForceBatch& inputs, int i);
+        void advance(Track& track, double T, double maxStep, const kernel::ForceBatch& inputs, int i);
+        Vector6d rhs(const Vector6d& y, const kernel::ForceBatch& inputs, int i);
+};
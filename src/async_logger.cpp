@@ -0,0 +1,99 @@
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include "async_logger.hpp"
+#include "defines.hpp"
+
+AsyncLogger::AsyncLogger(OverflowPolicy policy, size_t capacity)
+    : policy{policy}, ring(std::bit_ceil(capacity)), mask{ring.size() - 1},
+    head{0}, tail{0}, dropped{0}, written{0}, running{true}
+{
+    writer = std::thread(&AsyncLogger::writerLoop, this);
+}
+
+AsyncLogger::~AsyncLogger()
+{
+    running = false;
+    if(writer.joinable())
+    {
+        writer.join();
+    }
+    if(getDropped() > 0)
+    {
+        std::cerr << "Trajectory log dropped " << getDropped() << " samples" << std::endl;
+    }
+}
+
+bool AsyncLogger::logState(double time, uint64_t tick, int id, const double* state)
+{
+    Sample sample{Sample::Kind::state, id, time, {}};
+    std::memcpy(sample.data, state, sizeof(sample.data));
+    return push(sample, true, tick);
+}
+
+bool AsyncLogger::logParams(double time, int id, double CS)
+{
+    return push({Sample::Kind::params, id, time, {CS}}, false, 0);
+}
+
+bool AsyncLogger::push(const Sample& sample, bool decimable, uint64_t tick)
+{
+    const size_t h = head.load(std::memory_order_relaxed);
+    size_t used = h - tail.load(std::memory_order_acquire);
+    if(policy == OverflowPolicy::block)
+    {
+        while(used >= ring.size())
+        {
+            std::this_thread::yield();
+            used = h - tail.load(std::memory_order_acquire);
+        }
+    }
+    else if(used >= ring.size()
+        || (policy == OverflowPolicy::decimate && decimable
+            && 2*used >= ring.size() && tick % def::LOG_DECIMATION != 0))
+    {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    ring[h & mask] = sample;
+    head.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+void AsyncLogger::writerLoop()
+{
+    Logger stateLogger("state.csv","time,id,PosX,PosY,PosZ,VelX,VelY,VelZ");
+    Logger paramsLogger("params.csv", "time,id,CS");
+    while(true)
+    {
+        const bool stopping = !running.load();
+        size_t t = tail.load(std::memory_order_relaxed);
+        const size_t h = head.load(std::memory_order_acquire);
+        for (; t != h; t++)
+        {
+            const Sample& sample = ring[t & mask];
+            if(sample.kind == Sample::Kind::state)
+            {
+                stateLogger.log(sample.time,{Eigen::Vector<double,1>(sample.id), Eigen::Map<const Eigen::Vector<double,6>>(sample.data)});
+            }
+            else
+            {
+                paramsLogger.log(sample.time,{static_cast<double>(sample.id), sample.data[0]});
+            }
+            tail.store(t + 1, std::memory_order_release);
+            written.fetch_add(1, std::memory_order_relaxed);
+        }
+        if(stopping) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(def::LOG_WRITER_PERIOD_MS));
+    }
+}
+
+bool AsyncLogger::policyFromString(const std::string& name, OverflowPolicy& policy)
+{
+    if(name == "drop") policy = OverflowPolicy::drop;
+    else if(name == "block") policy = OverflowPolicy::block;
+    else if(name == "decimate") policy = OverflowPolicy::decimate;
+    else return false;
+    return true;
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include "common.hpp"
+
+/// @brief Behaviour of AsyncLogger when writer thread can not keep up
+enum class OverflowPolicy
+{
+    /// @brief discard new samples when buffer is full
+    drop,
+    /// @brief wait for free space in buffer
+    block,
+    /// @brief keep only every def::LOG_DECIMATION tick when buffer is more than half full, drop when full
+    decimate
+};
+
+/// @brief Trajectory and object params logger. Samples are passed to background writer thread
+/// by bounded lock-free ring buffer, so disk I/O never blocks simulation loop.
+/// Ring is single producer: simulation thread is the only caller of log functions.
+/// Counters can be read from any thread, e.g. by tick stats report.
+class AsyncLogger
+{
+    public:
+        /// @brief Constructor. Starts writer thread
+        /// @param policy overflow policy
+        /// @param capacity number of samples in ring buffer, rounded up to power of two
+        AsyncLogger(OverflowPolicy policy, size_t capacity);
+
+        AsyncLogger(const AsyncLogger&) = delete; // no copies
+        AsyncLogger& operator=(const AsyncLogger&) = delete; // no self-assignments
+
+        /// @brief Deconstructor. Writes remaining samples and stops writer thread
+        ~AsyncLogger();
+
+        /// @brief Log state of single object
+        /// @param time simulation time
+        /// @param tick simulation step number, used by decimation
+        /// @param id object id
+        /// @param state position and velocity of object
+        /// @return true if sample was accepted
+        bool logState(double time, uint64_t tick, int id, const double* state);
+
+        /// @brief Log params of new object
+        /// @param time simulation time
+        /// @param id object id
+        /// @param CS aerodynamic drag force cofficent multipled by aerodynamic field
+        /// @return true if sample was accepted
+        bool logParams(double time, int id, double CS);
+
+        /// @brief Get number of samples discarded due to overflow
+        inline uint64_t getDropped() const {return dropped.load(std::memory_order_relaxed);}
+
+        /// @brief Get number of samples written to files
+        inline uint64_t getWritten() const {return written.load(std::memory_order_relaxed);}
+
+        /// @brief Parse overflow policy name
+        /// @param name "drop", "block" or "decimate"
+        /// @param policy output policy
+        /// @return false if name is unknown
+        static bool policyFromString(const std::string& name, OverflowPolicy& policy);
+
+    private:
+        struct Sample
+        {
+            enum class Kind : uint8_t {state, params} kind;
+            int id;
+            double time;
+            double data[6];
+        };
+
+        const OverflowPolicy policy;
+        std::vector<Sample> ring;
+        const size_t mask;
+        alignas(64) std::atomic<size_t> head;
+        alignas(64) std::atomic<size_t> tail;
+        std::atomic<uint64_t> dropped;
+        std::atomic<uint64_t> written;
+        std::atomic_bool running;
+        std::thread writer;
+
+        bool push(const Sample& sample, bool decimable, uint64_t tick);
+        void writerLoop();
+};
@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <cmath>
+#include "atmosphere.hpp"
+#include "defines.hpp"
+
+namespace isa
+{
+    namespace
+    {
+        const double EARTH_RADIUS = 6356766.0;
+        const double G0 = 9.80665;
+        const double R = 287.05287;
+        const double GAMMA = 1.4;
+        const double T0 = 288.15;
+        const double P0 = 101325.0;
+
+        /// @brief Layer bases in geopotential m and temperature gradients in K/m
+        const double BASE[] = {0.0, 11000.0, 20000.0, 32000.0, 47000.0, 51000.0, 71000.0};
+        const double LAPSE[] = {-0.0065, 0.0, 0.001, 0.0028, 0.0, -0.0028, -0.002};
+        const int LAYERS = sizeof(BASE)/sizeof(BASE[0]);
+
+        /// @brief Find layer and its base temperature and pressure
+        void layer(double altitude, int& k, double& H, double& Tb, double& Pb)
+        {
+            H = EARTH_RADIUS*altitude/(EARTH_RADIUS + altitude);
+            Tb = T0;
+            Pb = P0;
+            k = 0;
+            while(k + 1 < LAYERS && H >= BASE[k+1])
+            {
+                const double dH = BASE[k+1] - BASE[k];
+                const double T = Tb + LAPSE[k]*dH;
+                Pb = LAPSE[k] == 0.0 ? Pb*std::exp(-G0*dH/(R*Tb)) : Pb*std::pow(T/Tb, -G0/(R*LAPSE[k]));
+                Tb = T;
+                k++;
+            }
+        }
+    }
+
+    double temperature(double altitude)
+    {
+        int k;
+        double H, Tb, Pb;
+        layer(altitude, k, H, Tb, Pb);
+        return Tb + LAPSE[k]*(H - BASE[k]);
+    }
+
+    double pressure(double altitude)
+    {
+        int k;
+        double H, Tb, Pb;
+        layer(altitude, k, H, Tb, Pb);
+        const double T = Tb + LAPSE[k]*(H - BASE[k]);
+        if(LAPSE[k] == 0.0) return Pb*std::exp(-G0*(H - BASE[k])/(R*Tb));
+        return Pb*std::pow(T/Tb, -G0/(R*LAPSE[k]));
+    }
+
+    double density(double altitude)
+    {
+        return pressure(altitude)/(R*temperature(altitude));
+    }
+
+    double speedOfSound(double altitude)
+    {
+        return std::sqrt(GAMMA*R*temperature(altitude));
+    }
+} // namespace isa
+
+Atmosphere::Atmosphere(const std::string& model)
+    : _valid{model == "constant" || model == "ISA"}, _constant{model != "ISA"}
+{
+    if(_constant)
+    {
+        // two equal samples, so lookup is the same for both models
+        minAltitude = 0.0;
+        invStep = 1.0;
+        last = 1.0;
+        rho.assign(3, def::DEFAULT_AIR_DENSITY);
+        temp.assign(3, isa::temperature(0.0));
+        sound.assign(3, isa::speedOfSound(0.0));
+        return;
+    }
+    minAltitude = def::ATMOSPHERE_MIN_ALTITUDE;
+    invStep = 1.0/def::ATMOSPHERE_TABLE_STEP;
+    const int samples = static_cast<int>(std::ceil((def::ATMOSPHERE_MAX_ALTITUDE - minAltitude)*invStep)) + 1;
+    last = samples - 1;
+    // extra sample after the end, read with zero weight at top of table
+    for (int i = 0; i <= samples; i++)
+    {
+        const double altitude = minAltitude + std::min(i, samples - 1)*def::ATMOSPHERE_TABLE_STEP;
+        rho.push_back(isa::density(altitude));
+        temp.push_back(isa::temperature(altitude));
+        sound.push_back(isa::speedOfSound(altitude));
+    }
+}
+
+void Atmosphere::densities(const double* altitude, double* density, int n) const
+{
+    const double* table = rho.data();
+    for (int i = 0; i < n; i++)
+    {
+        double u = (altitude[i] - minAltitude)*invStep;
+        u = u > 0.0 ? (u < last ? u : last) : 0.0;
+        const int k = static_cast<int>(u);
+        density[i] = table[k] + (u - k)*(table[k+1] - table[k]);
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <string>
+#include <vector>
+
+/// @brief Analytic International Standard Atmosphere, 1976 model of lower 86 km.
+/// Used to build lookup tables of Atmosphere and as reference in tests.
+/// Altitude is geometric height above sea level in m
+namespace isa
+{
+    /// @brief Air temperature in K
+    double temperature(double altitude);
+
+    /// @brief Air pressure in Pa
+    double pressure(double altitude);
+
+    /// @brief Air density in kg/m3
+    double density(double altitude);
+
+    /// @brief Speed of sound in m/s
+    double speedOfSound(double altitude);
+} // namespace isa
+
+/// @brief Atmosphere properties vs altitude, served from precomputed tables with linear interpolation.
+/// Tables of ISA model have def::ATMOSPHERE_TABLE_STEP spacing and stay in cache, so lookup is cheaper
+/// than evaluating exp/pow of analytic model. Outside table range values of nearest end are used.
+/// Altitude is height above sea level in m, in simulation coordinates it is -z
+class Atmosphere
+{
+    public:
+        /// @brief Constructor
+        /// @param model name of model: "constant" (sea level density def::DEFAULT_AIR_DENSITY
+        /// at every altitude) or "ISA"
+        explicit Atmosphere(const std::string& model);
+
+        /// @brief Check if model is known
+        /// @return true if model is known
+        inline bool valid() const {return _valid;}
+
+        /// @brief Check if properties do not depend on altitude
+        /// @return true for constant model
+        inline bool constant() const {return _constant;}
+
+        /// @brief Get air density
+        /// @param altitude altitude in m
+        /// @return density in kg/m3
+        inline double density(double altitude) const {return lookup(rho,altitude);}
+
+        /// @brief Get air temperature
+        /// @param altitude altitude in m
+        /// @return temperature in K
+        inline double temperature(double altitude) const {return lookup(temp,altitude);}
+
+        /// @brief Get speed of sound
+        /// @param altitude altitude in m
+        /// @return speed of sound in m/s
+        inline double speedOfSound(double altitude) const {return lookup(sound,altitude);}
+
+        /// @brief Get air density of many objects
+        /// @param altitude altitudes of objects in m
+        /// @param density output, densities in kg/m3
+        /// @param n number of objects
+        void densities(const double* altitude, double* density, int n) const;
+
+    private:
+        bool _valid;
+        bool _constant;
+        double minAltitude;
+        double invStep;
+        double last;
+        std::vector<double> rho, temp, sound;
+
+        inline double lookup(const std::vector<double>& table, double altitude) const
+        {
+            double u = (altitude - minAltitude)*invStep;
+            // written so that NaN gives first sample and never reaches conversion to int
+            u = u > 0.0 ? (u < last ? u : last) : 0.0;
+            const int i = static_cast<int>(u);
+            return table[i] + (u - i)*(table[i+1] - table[i]);
+        }
+};
@@ -0,0 +1,67 @@
+#pragma once
+#include <Eigen/Dense>
+#include <variant>
+
+/// @brief Parsed control commands. Produced by control listener, applied to engine by simulation thread
+namespace cmd
+{
+    /// @brief Add new object. Id is reserved by producer, so reply can be sent before command is applied
+    struct Add
+    {
+        /// @brief reserved object id
+        int id;
+        /// @brief object mass
+        double mass;
+        /// @brief aerodynamic drag force cofficent multipled by aerodynamic field
+        double CS;
+        /// @brief start position
+        Eigen::Vector3d pos;
+        /// @brief start velocity
+        Eigen::Vector3d vel;
+    };
+
+    /// @brief Remove object
+    struct Remove
+    {
+        /// @brief object id
+        int id;
+    };
+
+    /// @brief Set wind affecting object, or make it follow wind field again
+    struct Wind
+    {
+        /// @brief object id
+        int id;
+        /// @brief wind speed vector in m/s
+        Eigen::Vector3d wind;
+        /// @brief drop own wind of object, wind is ignored
+        bool field = false;
+    };
+
+    /// @brief Apply outer force to object
+    struct Force
+    {
+        /// @brief object id
+        int id;
+        /// @brief force vector in N
+        Eigen::Vector3d force;
+    };
+
+    /// @brief Collision with solid surface
+    struct Collision
+    {
+        /// @brief object id
+        int id;
+        /// @brief coefficient of restitution
+        double COR;
+        /// @brief static friction cofficient
+        double mi_static;
+        /// @brief dynamic friction cofficient
+        double mi_dynamic;
+        /// @brief surface normal vector
+        Eigen::Vector3d surfaceNormal;
+    };
+
+    /// @brief Any control command
+    using Command = std::variant<Add,Remove,Wind,Force,Collision>;
+} // namespace cmd
@@ -0,0 +1,276 @@
+#include <Eigen/Dense>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <iostream>
+#include <type_traits>
+#include "command_parser.hpp"
+#include "state.hpp"
+
+namespace cmd
+{
+    /// @brief Drop ASCII whitespace around text
+    static std::string_view trim(std::string_view text)
+    {
+        constexpr std::string_view whitespace = " \t\r\n\v\f";
+        const size_t first = text.find_first_not_of(whitespace);
+        if(first == std::string_view::npos) return text.substr(text.size());
+        return text.substr(first, text.find_last_not_of(whitespace) - first + 1);
+    }
+
+    /// @brief Reads comma separated numbers of one message, without copies
+    class Fields
+    {
+        public:
+            explicit Fields(std::string_view text) : rest{text}, end{false} {}
+
+            /// @brief Parse next field. Whole field without surrounding whitespace has to be a number,
+            /// floating point numbers have to be finite
+            template<typename T>
+            Error next(T& value)
+            {
+                if(end) return Error::missing;
+                const size_t comma = rest.find(',');
+                const std::string_view field = trim(rest.substr(0,comma));
+                if(comma == std::string_view::npos)
+                {
+                    end = true;
+                }
+                else
+                {
+                    rest.remove_prefix(comma + 1);
+                }
+                const char* last = field.data() + field.size();
+                auto [ptr, ec] = std::from_chars(field.data(), last, value);
+                if(ec == std::errc::result_out_of_range) return Error::range;
+                if(ec != std::errc() || ptr != last) return Error::number;
+                if constexpr (std::is_floating_point_v<T>)
+                {
+                    if(!std::isfinite(value)) return Error::range;
+                }
+                return Error::none;
+            }
+
+            /// @brief Parse next three fields as vector
+            Error next(Eigen::Vector3d& value)
+            {
+                for (int i = 0; i < 3; i++)
+                {
+                    Error error = next(value(i));
+                    if(error != Error::none) return error;
+                }
+                return Error::none;
+            }
+
+            /// @brief Check if all fields were read
+            inline bool done() const {return end;}
+
+        private:
+            std::string_view rest;
+            bool end;
+    };
+
+    /// @brief Parse all values in order, stops on first error
+    template<typename... T>
+    static Error read(Fields& fields, T&... values)
+    {
+        Error error = Error::none;
+        ((error = error == Error::none ? fields.next(values) : error), ...);
+        return error;
+    }
+
+    /// @brief Check that all fields were read
+    static Error finish(Error error, const Fields& fields)
+    {
+        if(error == Error::none && !fields.done()) return Error::extra;
+        return error;
+    }
+
+    static bool isNormal(double factor)
+    {
+        return factor >= 0.0 && factor <= 1.0;
+    }
+
+    static Error parseAdd(std::string_view args, std::vector<Command>& batch)
+    {
+        Fields fields(args);
+        double m, CS;
+        Eigen::Vector3d pos, vel = Eigen::Vector3d::Zero();
+        Error error = read(fields, m, CS, pos);
+        if(error == Error::none && !fields.done()) error = read(fields, vel);
+        error = finish(error, fields);
+        if(error != Error::none) return error;
+        if(m <= 0.0 || CS < 0.0) return Error::range;
+        batch.push_back(Add{ObjParams::nextId(),m,CS,pos,vel});
+        return Error::none;
+    }
+
+    static Error parseRemove(std::string_view args, std::vector<Command>& batch)
+    {
+        Fields fields(args);
+        int id;
+        Error error = finish(read(fields, id), fields);
+        if(error != Error::none) return error;
+        if(id < 0) return Error::range;
+        batch.push_back(Remove{id});
+        return Error::none;
+    }
+
+    static Error parseWind(std::string_view args, std::vector<Command>& batch)
+    {
+        const size_t size = batch.size();
+        while(true)
+        {
+            const size_t semicolon = args.find(';');
+            Fields fields(args.substr(0,semicolon));
+            int id;
+            Eigen::Vector3d wind = Eigen::Vector3d::Zero();
+            Error error = read(fields, id);
+            // item with id only drops own wind of object
+            const bool field = error == Error::none && fields.done();
+            if(!field) error = finish(error == Error::none ? read(fields, wind) : error, fields);
+            if(error == Error::none && id < 0) error = Error::range;
+            if(error != Error::none)
+            {
+                // wind message is applied whole or not at all
+                batch.erase(batch.begin() + size, batch.end());
+                return error;
+            }
+            batch.push_back(Wind{id,wind,field});
+            if(semicolon == std::string_view::npos) return Error::none;
+            args.remove_prefix(semicolon + 1);
+            // empty item after last separator is ignored
+            if(trim(args).empty()) return Error::none;
+        }
+    }
+
+    static Error parseForce(std::string_view args, std::vector<Command>& batch)
+    {
+        Fields fields(args);
+        int id;
+        Eigen::Vector3d force;
+        Error error = finish(read(fields, id, force), fields);
+        if(error != Error::none) return error;
+        if(id < 0) return Error::range;
+        batch.push_back(Force{id,force});
+        return Error::none;
+    }
+
+    static Error parseCollision(std::string_view args, std::vector<Command>& batch)
+    {
+        Fields fields(args);
+        int id;
+        double COR, mi_static, mi_dynamic;
+        Eigen::Vector3d surfaceNormal;
+        Error error = finish(read(fields, id, COR, mi_static, mi_dynamic, surfaceNormal), fields);
+        if(error != Error::none) return error;
+        if(id < 0
+            || !isNormal(COR)
+            || !isNormal(mi_static)
+            || !isNormal(mi_dynamic)
+            || mi_static < mi_dynamic)
+        {
+            return Error::range;
+        }
+        batch.push_back(Collision{id,COR,mi_static,mi_dynamic,surfaceNormal});
+        return Error::none;
+    }
+
+    const char* errorName(Error error)
+    {
+        switch(error)
+        {
+            case Error::none:
+                return "none";
+            case Error::command:
+                return "command";
+            case Error::missing:
+                return "missing";
+            case Error::extra:
+                return "extra";
+            case Error::number:
+                return "number";
+            case Error::range:
+                return "range";
+        }
+        return "unknown";
+    }
+
+    Error parseCommand(std::string_view msg, std::vector<Command>& batch)
+    {
+        if(msg.size() < 2 || msg[1] != ':') return Error::command;
+        const std::string_view args = msg.substr(2);
+        switch(msg[0])
+        {
+            case 'a':
+                return parseAdd(args,batch);
+            case 'r':
+                return parseRemove(args,batch);
+            case 'w':
+                return parseWind(args,batch);
+            case 'f':
+                return parseForce(args,batch);
+            case 'j':
+                return parseCollision(args,batch);
+        }
+        return Error::command;
+    }
+
+    std::string parse(std::string_view msg, std::vector<Command>& batch)
+    {
+        Error error = parseCommand(msg,batch);
+        if(error != Error::none)
+        {
+            std::cerr << "Invalid command (" << errorName(error) << "): " << msg << std::endl;
+            return std::string("error;") + errorName(error);
+        }
+        if(msg[0] == 'a')
+        {
+            return "ok;" + std::to_string(std::get<Add>(batch.back()).id);
+        }
+        return "ok";
+    }
+
+    std::string parseBatch(std::string_view msg, std::vector<Command>& batch)
+    {
+        if(msg.size() < 2 || msg[1] != ':')
+        {
+            std::cerr << "Invalid command (" << errorName(Error::command) << "): " << msg << std::endl;
+            return std::string("error;") + errorName(Error::command);
+        }
+        const size_t size = batch.size();
+        std::vector<std::string> itemReplies;
+        bool valid = true;
+        std::string_view items = msg.substr(2);
+        while(!items.empty())
+        {
+            const size_t newline = items.find('\n');
+            itemReplies.push_back(parse(items.substr(0,newline),batch));
+            valid = valid && itemReplies.back().compare(0,2,"ok") == 0;
+            if(newline == std::string_view::npos) break;
+            items.remove_prefix(newline + 1);
+        }
+        if(!valid)
+        {
+            // batch is applied whole or not at all, ids reserved for skipped objects are not reported
+            batch.erase(batch.begin() + size, batch.end());
+        }
+        std::string replies = valid ? "ok" : "error";
+        for(const auto& reply: itemReplies)
+        {
+            replies += '\n';
+            replies += valid || reply.compare(0,2,"ok") != 0 ? reply : "skipped";
+        }
+        return replies;
+    }
+
+    bool parseImpactQuery(std::string_view msg, int& id, double& groundZ)
+    {
+        groundZ = 0.0;
+        if(msg.size() < 2 || msg[1] != ':') return false;
+        Fields fields(msg.substr(2));
+        Error error = read(fields, id);
+        if(error == Error::none && !fields.done()) error = read(fields, groundZ);
+        return finish(error, fields) == Error::none && id >= 0;
+    }
+} // namespace cmd
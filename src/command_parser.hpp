@@ -0,0 +1,68 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include "command.hpp"
+
+/// @brief Text control protocol
+namespace cmd
+{
+    /// @brief Reason of rejecting control message
+    enum class Error
+    {
+        /// @brief message is valid
+        none,
+        /// @brief unknown message type
+        command,
+        /// @brief message has too few fields
+        missing,
+        /// @brief message has too many fields
+        extra,
+        /// @brief field is not a number
+        number,
+        /// @brief number is out of range, not finite or breaks constraint of command
+        range
+    };
+
+    /// @brief Get name of error used in replies
+    /// @param error error code
+    /// @return short name, e.g. "number"
+    const char* errorName(Error error);
+
+    /// @brief Parse single control message and append resulting commands to batch. Does not throw and
+    /// does not allocate if batch has free capacity.
+    /// Supported messages:
+    /// "a:<mass>,<CS>,<x>,<y>,<z>[,<vx>,<vy>,<vz>]" add,
+    /// "r:<id>" remove,
+    /// "w:<id>,<x>,<y>,<z>[;<id>,<x>,<y>,<z>...]" wind, item with id only ("w:<id>") makes object follow wind field again,
+    /// "f:<id>,<x>,<y>,<z>" force,
+    /// "j:<id>,<COR>,<mi_static>,<mi_dynamic>,<nx>,<ny>,<nz>" solid surface collision.
+    /// Whitespace around fields is ignored, trailing ';' of wind message too.
+    /// Ids of added objects are reserved during parsing.
+    /// @param msg message content
+    /// @param batch output, commands are appended only if message is valid
+    /// @return error code
+    Error parseCommand(std::string_view msg, std::vector<Command>& batch);
+
+    /// @brief Parse single control message and make reply for client
+    /// @param msg message content
+    /// @param batch output, commands are appended only if message is valid
+    /// @return "ok;<id>" for add, "ok" for other valid commands, "error;<name>" otherwise
+    std::string parse(std::string_view msg, std::vector<Command>& batch);
+
+    /// @brief Parse batch message "b:" followed by single messages separated by new line.
+    /// Items are appended to batch only if all of them are valid, so batch is applied whole in one step or not at all.
+    /// @param msg message content
+    /// @param batch output
+    /// @return reply for client: "ok" if all items are valid, "error" otherwise,
+    /// followed by reply of every item, each in new line. If batch is rejected, valid items reply "skipped"
+    /// and ids reserved for them are not reported. "error;command" if message does not start with "b:"
+    std::string parseBatch(std::string_view msg, std::vector<Command>& batch);
+
+    /// @brief Parse impact prediction query "p:<id>[,<groundZ>]"
+    /// @param msg message content
+    /// @param id output, object id
+    /// @param groundZ output, z coordinate of ground plane, 0 if not given
+    /// @return false if message is invalid
+    bool parseImpactQuery(std::string_view msg, int& id, double& groundZ);
+} // namespace cmd
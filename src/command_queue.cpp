@@ -0,0 +1,54 @@
+#include "command_queue.hpp"
+
+CommandQueue::CommandQueue()
+    : spare{nullptr}
+{
+    tail = new Node();
+    head = tail;
+}
+
+CommandQueue::~CommandQueue()
+{
+    while(tail != nullptr)
+    {
+        Node* next = tail->next.load(std::memory_order_relaxed);
+        delete tail;
+        tail = next;
+    }
+    delete spare.load(std::memory_order_relaxed);
+}
+
+CommandQueue::Node* CommandQueue::acquire()
+{
+    Node* node = spare.exchange(nullptr, std::memory_order_acq_rel);
+    return node != nullptr ? node : new Node();
+}
+
+void CommandQueue::link(Node* node)
+{
+    Node* prev = head.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+}
+
+void CommandQueue::push(std::vector<cmd::Command>&& batch)
+{
+    if(batch.empty()) return;
+    Node* node = acquire();
+    node->commands = std::move(batch);
+    link(node);
+}
+
+void CommandQueue::push(const std::vector<cmd::Command>& batch)
+{
+    if(batch.empty()) return;
+    Node* node = acquire();
+    node->commands.assign(batch.begin(), batch.end());
+    link(node);
+}
+
+void CommandQueue::push(cmd::Command&& command)
+{
+    std::vector<cmd::Command> batch;
+    batch.push_back(std::move(command));
+    push(std::move(batch));
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <atomic>
+#include <vector>
+#include "command.hpp"
+
+/// @brief Unbounded lock-free multi producer, single consumer queue of command batches.
+/// Producers push whole batches with single atomic exchange, consumer drains them at step boundary.
+/// Commands of one batch are always drained together. Last drained node is kept as spare and reused by next push,
+/// so with one batch per step and batches copied by push(const&) queue does not allocate in steady state.
+class CommandQueue
+{
+    public:
+        /// @brief Constructor
+        CommandQueue();
+
+        CommandQueue(const CommandQueue&) = delete; // no copies
+        CommandQueue& operator=(const CommandQueue&) = delete; // no self-assignments
+
+        /// @brief Deconstructor. Discards not drained commands
+        ~CommandQueue();
+
+        /// @brief Enqueue batch of commands. Safe to call from many threads
+        /// @param batch commands, kept in order
+        void push(std::vector<cmd::Command>&& batch);
+
+        /// @brief Enqueue copy of batch of commands, so caller can reuse its buffer. Safe to call from many threads.
+        /// Allocates only if spare node is not available or batch does not fit into its capacity
+        /// @param batch commands, kept in order
+        void push(const std::vector<cmd::Command>& batch);
+
+        /// @brief Enqueue single command. Safe to call from many threads
+        /// @param command command
+        void push(cmd::Command&& command);
+
+        /// @brief Apply all commands pushed so far in FIFO order. Only one thread may drain.
+        /// Does not allocate memory
+        /// @param apply function called for every command
+        /// @return number of applied commands
+        template<typename F>
+        int drain(F&& apply)
+        {
+            int applied = 0;
+            Node* next = tail->next.load(std::memory_order_acquire);
+            while(next != nullptr)
+            {
+                for(const auto& command: next->commands)
+                {
+                    apply(command);
+                    applied++;
+                }
+                recycle(tail);
+                tail = next;
+                next = tail->next.load(std::memory_order_acquire);
+            }
+            return applied;
+        }
+
+    private:
+        struct Node
+        {
+            std::atomic<Node*> next{nullptr};
+            std::vector<cmd::Command> commands;
+        };
+
+        std::atomic<Node*> head;
+        Node* tail;
+        std::atomic<Node*> spare;
+
+        Node* acquire();
+        void link(Node* node);
+
+        inline void recycle(Node* node)
+        {
+            node->next.store(nullptr, std::memory_order_relaxed);
+            node->commands.clear();
+            Node* empty = nullptr;
+            if(!spare.compare_exchange_strong(empty, node, std::memory_order_acq_rel)) delete node;
+        }
+};
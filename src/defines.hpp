@@ -16,6 +16,83 @@ namespace def
     /// Dry air density in normal conditions in kg/m3
     const double DEFAULT_AIR_DENSITY = 1.224;
 
+    /// @brief lowest altitude in atmosphere tables in m
+    const double ATMOSPHERE_MIN_ALTITUDE = -1000.0;
+
+    /// @brief highest altitude in atmosphere tables in m, top of ISA model
+    const double ATMOSPHERE_MAX_ALTITUDE = 86000.0;
+
+    /// @brief altitude between samples of atmosphere tables in m
+    const double ATMOSPHERE_TABLE_STEP = 50.0;
+
     /// @brief how many steps outer force should be valid
     const static int VALIDITY_OF_FORCE = 1;
+
+    /// @brief number of object slots preallocated at start. Pool doubles when exhausted, which reallocates
+    /// and copies whole state in the step that adds the object, so set it above expected object count
+    /// to keep step time flat
+    const static int INITIAL_OBJ_CAPACITY = 64;
+
+    /// @brief number of commands reserved in control listener batch buffer and reused between messages
+    const static int CONTROL_BATCH_RESERVE = 256;
+
+    /// @brief number of samples buffered for trajectory log writer thread
+    const static int LOG_BUFFER_SIZE = 1 << 15;
+
+    /// @brief with decimate overflow policy, only every n-th tick is logged when log buffer is more than half full
+    const static int LOG_DECIMATION = 10;
+
+    /// @brief how often log writer thread wakes up to flush buffered samples in ms
+    const static int LOG_WRITER_PERIOD_MS = 5;
+
+    /// @brief object slower than this in m/s may fall asleep
+    const double SLEEP_SPEED = 0.2;
+
+    /// @brief object with outer force stronger than this in N does not fall asleep
+    const double SLEEP_FORCE = 0.01;
+
+    /// @brief number of consecutive slow steps after which object falls asleep
+    const static int SLEEP_STEPS = 100;
+
+    /// @brief sleeping objects are published every n ticks
+    const static int SLEEP_PUBLISH_INTERVAL = 100;
+
+    /// @brief relative tolerance of adaptive integrator
+    const double ADAPTIVE_RTOL = 1e-6;
+
+    /// @brief absolute tolerance of adaptive integrator
+    const double ADAPTIVE_ATOL = 1e-6;
+
+    /// @brief longest step of adaptive integrator in s
+    const double ADAPTIVE_MAX_STEP = 1.0;
+
+    /// @brief shortest step of adaptive integrator in s. Step is accepted at this length even if error is above tolerance
+    const double ADAPTIVE_MIN_STEP = 1e-6;
+
+    /// @brief longest lookahead of impact prediction in s
+    const double PREDICTION_HORIZON = 120.0;
+
+    /// @brief how long impact prediction query waits for result in ms
+    const static int PREDICTION_TIMEOUT_MS = 100;
+
+    /// @brief number of ensemble realizations integrated together by one worker
+    const static int ENSEMBLE_BATCH = 256;
+
+    /// @brief number of objects integrated by one task of parallel step. Multiple of SIMD width of force kernel
+    const static int PARALLEL_CHUNK = 512;
+
+    /// @brief smallest number of awake objects integrated in parallel
+    const static int PARALLEL_MIN_OBJECTS = 2048;
+
+    /// @brief number of frames kept in shared memory state ring
+    const static int SHM_RING_SLOTS = 8;
+
+    /// @brief largest number of objects in frame of shared memory state ring
+    const static int SHM_RING_MAX_OBJECTS = 1 << 16;
+
+    /// @brief in delta mode topic stream sends all objects every n updates
+    const static int KEYFRAME_INTERVAL = 100;
+
+    /// @brief tick statistics are published every n ticks
+    const static int STATS_PUBLISH_INTERVAL = 1000;
 } // namespace def
\ No newline at end of file
@@ -0,0 +1,253 @@
+#include <Eigen/Dense>
+#include <algorithm>
+#include <type_traits>
+#include <variant>
+#include "engine.hpp"
+#include "defines.hpp"
+
+Engine::Engine(const Params& params)
+    : _params{params}, atmosphere{params.ATMOSPHERE}, integrator{params.ODE_METHOD},
+    adaptive{params.ODE_METHOD, atmosphere}, pool{params.THREADS},
+    loadFailed{false}
+{
+    if(!integrator.valid() && !adaptive.valid())
+    {
+        ode = ODE::factory(ODE::fromString(params.ODE_METHOD));
+    }
+    if(!params.TERRAIN.empty() && !terrain.load(params.TERRAIN))
+    {
+        loadFailed = true;
+    }
+    if(!params.WIND_FIELD.empty() && !windField.load(params.WIND_FIELD))
+    {
+        loadFailed = true;
+    }
+    reserve();
+}
+
+bool Engine::valid() const
+{
+    return (integrator.valid() || adaptive.valid() || ode != nullptr) && atmosphere.valid() && !loadFailed;
+}
+
+void Engine::step()
+{
+    state.compact();
+    reserve();
+    disturbed.clear();
+    captureInputs();
+    if(integrator.valid() && pool.size() > 1 && state.getNoAwake() >= def::PARALLEL_MIN_OBJECTS)
+    {
+        integrateParallel();
+    }
+    else if(integrator.valid())
+    {
+        integrator.step(state.real_time, state.getAwakeView(), _params.STEP_TIME,
+            [this](double t, const Eigen::Ref<const Eigen::VectorXd>& y, Eigen::Ref<Eigen::VectorXd> dydt)
+            {
+                calcRHS(t,y,dydt);
+            });
+    }
+    else if(adaptive.valid())
+    {
+        adaptive.step(state, batch, state.real_time, _params.STEP_TIME);
+    }
+    else if(state.getNoAwake() > 0)
+    {
+        auto RHS = [this](double t, Eigen::VectorXd y)
+        {
+            Eigen::VectorXd res(y.size());
+            calcRHS(t,y,res);
+            return res;
+        };
+        state.getAwakeView() = ode->step(state.real_time,state.getAwakeView(),RHS,_params.STEP_TIME);
+    }
+    if(terrain.loaded()) collideTerrain();
+    state.real_time += _params.STEP_TIME;
+    state.tick++;
+    updateSleep();
+}
+
+void Engine::integrateParallel()
+{
+    const int no = state.getNoAwake();
+    const int chunks = (no + def::PARALLEL_CHUNK - 1)/def::PARALLEL_CHUNK;
+    auto y = state.getAwakeView();
+    const double t = state.real_time;
+    const double h = _params.STEP_TIME;
+    // objects are independent, so every chunk is integrated with its own part of stage buffers and force batch
+    auto task = [&](int chunk)
+    {
+        const int first = chunk*def::PARALLEL_CHUNK;
+        const int len = std::min(def::PARALLEL_CHUNK, no - first);
+        integrator.stepSegment(t, y.segment(6*first,6*len), 6*first, h,
+            [this,first](double t, const Eigen::Ref<const Eigen::VectorXd>& y, Eigen::Ref<Eigen::VectorXd> dydt)
+            {
+                calcRHS(t,y,dydt,first);
+            });
+    };
+    pool.parallelFor(chunks,task);
+}
+
+void Engine::updateSleep()
+{
+    const double speed2 = def::SLEEP_SPEED*def::SLEEP_SPEED;
+    const double force2 = def::SLEEP_FORCE*def::SLEEP_FORCE;
+    for (int i = 0; i < state.getNoAwake(); i++)
+    {
+        ObjParams* p = state.getParams(i);
+        const double f2 = batch.fx[i]*batch.fx[i] + batch.fy[i]*batch.fy[i] + batch.fz[i]*batch.fz[i];
+        if(state.getVel(i).squaredNorm() >= speed2 || f2 >= force2)
+        {
+            p->slowSteps = 0;
+            continue;
+        }
+        if(++p->slowSteps >= def::SLEEP_STEPS)
+        {
+            state.sleep(i);
+            disturbed.push_back(p->id);
+        }
+    }
+}
+
+int Engine::addObj(double mass, double CS,
+    Eigen::Vector3d pos, Eigen::Vector3d vel) 
+{
+    return state.addObj(mass,CS,pos,vel);
+}
+
+void Engine::removeObj(int id)
+{
+    state.removeObj(id);
+}
+
+void Engine::apply(const cmd::Command& command)
+{
+    std::visit([this](const auto& c)
+    {
+        using T = std::decay_t<decltype(c)>;
+        if constexpr (std::is_same_v<T,cmd::Add>)
+        {
+            state.addObjWithId(c.id,c.mass,c.CS,c.pos,c.vel);
+        }
+        else if constexpr (std::is_same_v<T,cmd::Remove>)
+        {
+            removeObj(c.id);
+        }
+        else if constexpr (std::is_same_v<T,cmd::Wind>)
+        {
+            if(c.field)
+            {
+                state.clearWind(c.id);
+            }
+            else
+            {
+                state.updateWind(c.id,c.wind);
+            }
+        }
+        else if constexpr (std::is_same_v<T,cmd::Force>)
+        {
+            state.updateForce(c.id,c.force);
+        }
+        else if constexpr (std::is_same_v<T,cmd::Collision>)
+        {
+            calcImpulseForce(c.id,c.COR,c.mi_static,c.mi_dynamic,c.surfaceNormal);
+        }
+    }, command);
+}
+
+void Engine::reserve()
+{
+    integrator.reserve(6*state.getCapacity());
+    batch.reserve(state.getCapacity());
+    adaptive.reserve(state.getCapacity());
+    if(terrain.loaded() && startPos.cols() < state.getCapacity()) startPos.resize(3,state.getCapacity());
+    // object can be both bounced and put to sleep in one step
+    if(static_cast<int>(disturbed.capacity()) < 2*state.getCapacity()) disturbed.reserve(2*state.getCapacity());
+}
+
+void Engine::calcImpulseForce(int id,double COR, double mi_static, double mi_dynamic, Eigen::Vector3d surfaceNormal)
+{
+    int index = state.findIndex(id);
+    if(index < 0) return;
+    applyImpulse(index,COR,mi_static,mi_dynamic,surfaceNormal);
+}
+
+bool Engine::applyImpulse(int index, double COR, double mi_static, double mi_dynamic, const Eigen::Vector3d& surfaceNormal)
+{
+    Eigen::Vector3d v = state.getVel(index);
+    Eigen::Vector3d X_g = v;
+    double vn = v.dot(surfaceNormal);
+    if(vn >= 0.0)
+    {
+        return false;
+    }
+    state.wake(index);
+    double mass = state.getParams(index)->mass;
+    if(vn > -def::GENTLY_PUSH) vn = -def::GENTLY_PUSH;
+    double jr = (-(1+COR)*vn)*mass;
+    X_g = X_g + (jr/mass)*surfaceNormal;
+    Eigen::Vector3d vt = v - (v.dot(surfaceNormal))*surfaceNormal;
+    if(vt.squaredNorm() > def::FRICTION_EPS)
+    {
+        Eigen::Vector3d tangent = vt.normalized();
+        double js = mi_static*jr;
+        double jd = mi_dynamic*jr;
+        double jf = vt.norm() * mass;
+        if(jf > js) jf = jd;
+        X_g = X_g - (jf/mass) * tangent;
+    }
+    state.setVel(index,X_g);
+    return true;
+}
+
+void Engine::collideTerrain()
+{
+    Terrain::Hit hit;
+    for (int i = 0; i < state.getNoAwake(); i++)
+    {
+        if(!terrain.sweep(startPos.col(i), state.getPos(i), hit)) continue;
+        state.setPos(i,hit.pos);
+        applyImpulse(i,hit.material.COR,hit.material.mi_static,hit.material.mi_dynamic,hit.normal);
+        disturbed.push_back(state.getParams(i)->id);
+    }
+}
+
+void Engine::captureInputs()
+{
+    const int no = state.getNoAwake();
+    const bool field = windField.loaded();
+    // field is interpolated in time once per step, objects sample it at start position
+    const WindField::Frame frame = field ? windField.at(state.real_time) : WindField::Frame();
+    for (int i = 0; i < no; i++)
+    {
+        ObjParams* p = state.getParams(i);
+        const Eigen::Vector3d wind = field && !p->hasWind() ? frame(state.getPos(i)) : p->getWind();
+        const Eigen::Vector3d force = p->takeForce();
+        batch.wx[i] = wind.x();
+        batch.wy[i] = wind.y();
+        batch.wz[i] = wind.z();
+        batch.fx[i] = force.x();
+        batch.fy[i] = force.y();
+        batch.fz[i] = force.z();
+        batch.mass[i] = p->mass;
+        batch.CS[i] = p->CS_coff;
+    }
+    if(terrain.loaded())
+    {
+        for (int i = 0; i < no; i++)
+        {
+            startPos.col(i) = state.getPos(i);
+        }
+    }
+}
+
+void Engine::calcRHS(double t, const Eigen::Ref<const Eigen::VectorXd>& y, Eigen::Ref<Eigen::VectorXd> dydt)
+{
+    calcRHS(t,y,dydt,0);
+}
+
+void Engine::calcRHS(double, const Eigen::Ref<const Eigen::VectorXd>& y, Eigen::Ref<Eigen::VectorXd> dydt, int first)
+{
+    kernel::derivatives(batch,atmosphere,y,dydt,first);
+}
@@ -0,0 +1,124 @@
+#pragma once
+#include <Eigen/Dense>
+#include <memory>
+#include <vector>
+#include "state.hpp"
+#include "integrator.hpp"
+#include "adaptive_integrator.hpp"
+#include "atmosphere.hpp"
+#include "force_kernel.hpp"
+#include "command.hpp"
+#include "thread_pool.hpp"
+#include "terrain.hpp"
+#include "wind_field.hpp"
+#include "common.hpp"
+#include "params.hpp"
+
+/// @brief Physics core of simulation. Owns state and integrates it without any communication,
+/// so it can be driven by live loop, tests or benchmarks.
+class Engine
+{
+    public:
+        /// @brief Constructor
+        /// @param params simulation params
+        Engine(const Params& params);
+
+        /// @brief Check if engine was configured correctly
+        /// @return true if ODE method and atmosphere model are available and terrain and wind field, if set, were loaded
+        bool valid() const;
+
+        /// @brief Make one simulation step of Params::STEP_TIME. Sleeping objects are not integrated.
+        /// Large swarms are integrated by Params::THREADS threads, result does not depend on number of threads.
+        /// If terrain is loaded, objects that went below ground during step are put on surface and bounced.
+        /// In steady state (no new objects above reserved capacity) does not allocate memory.
+        void step();
+
+        /// @brief Get simulation state
+        /// @return reference to state
+        inline State& getState() {return state;}
+
+        /// @brief Get terrain, loaded from Params::TERRAIN
+        /// @return reference to terrain
+        inline Terrain& getTerrain() {return terrain;}
+
+        /// @brief Get wind field, loaded from Params::WIND_FIELD
+        /// @return reference to wind field
+        inline WindField& getWindField() {return windField;}
+
+        /// @brief Get atmosphere, given by Params::ATMOSPHERE
+        /// @return reference to atmosphere
+        inline const Atmosphere& getAtmosphere() const {return atmosphere;}
+
+        /// @brief Get ids of objects whose velocity was changed by engine itself during last step,
+        /// i.e. bounced from terrain or put to sleep. Changes made by commands are not included
+        /// @return ids of objects
+        inline const std::vector<int>& getDisturbed() const {return disturbed;}
+
+        /// @brief Get adaptive integrator, used when Params::ODE_METHOD is "DOPRI5"
+        /// @return reference to adaptive integrator
+        inline const AdaptiveIntegrator& getAdaptiveIntegrator() const {return adaptive;}
+
+        /// @brief Add new object to simulation
+        /// @param mass obj mass
+        /// @param CS aerodynamic drag force cofficent multipled by aerodynamic field
+        /// @param pos start position of object
+        /// @param vel start velocity of object
+        /// @return id of added object
+        int addObj(double mass, double CS,
+            Eigen::Vector3d pos, Eigen::Vector3d vel = Eigen::Vector3d::Zero());
+
+        /// @brief Remove object from simulation
+        /// @param id object id
+        void removeObj(int id);
+
+        /// @brief Apply control command. Should be called between steps
+        /// @param command parsed command
+        void apply(const cmd::Command& command);
+
+        /// @brief Calculates object state after collision with given surface
+        /// @param id object id
+        /// @param COR coefficient of restitution. e = 0 is perfect inelastic collision, e = 1 is perfect elastic collision.
+        /// 0 < e < 1 is a real-world inelastic collision, in which some kinetic energy is dissipated.
+        /// @param mi_static static friction cofficient
+        /// @param mi_dynamic dynamic friction cofficient
+        /// @param surfaceNormal surface normal vector
+        void calcImpulseForce(int id, double COR,
+            double mi_static, double mi_dynamic, Eigen::Vector3d surfaceNormal);
+
+        /// @brief Right hand side of motion equations for all objects.
+        /// Uses wind and outer forces captured at the beginning of step, so it does not touch object params
+        /// @param t time
+        /// @param y state of objects
+        /// @param dydt output, derivative of state
+        void calcRHS(double t, const Eigen::Ref<const Eigen::VectorXd>& y, Eigen::Ref<Eigen::VectorXd> dydt);
+
+        /// @brief Right hand side of motion equations for consecutive objects
+        /// @param t time
+        /// @param y state of objects
+        /// @param dydt output, derivative of state
+        /// @param first index of first object in y
+        void calcRHS(double t, const Eigen::Ref<const Eigen::VectorXd>& y, Eigen::Ref<Eigen::VectorXd> dydt, int first);
+
+    private:
+        const Params& _params;
+        State state;
+        Atmosphere atmosphere;
+        Integrator integrator;
+        AdaptiveIntegrator adaptive;
+        std::unique_ptr<ODE> ode;
+        kernel::ForceBatch batch;
+        ThreadPool pool;
+        Terrain terrain;
+        WindField windField;
+        bool loadFailed;
+        Eigen::Matrix3Xd startPos;
+        std::vector<int> disturbed;
+
+        void reserve();
+        void captureInputs();
+        void integrateParallel();
+        void collideTerrain();
+        bool applyImpulse(int index, double COR,
+            double mi_static, double mi_dynamic, const Eigen::Vector3d& surfaceNormal);
+        void updateSleep();
+};
@@ -0,0 +1,333 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <thread>
+#include "ensemble.hpp"
+#include "integrator.hpp"
+#include "force_kernel.hpp"
+#include "atmosphere.hpp"
+#include "thread_pool.hpp"
+#include "defines.hpp"
+
+namespace ensemble
+{
+    namespace
+    {
+        struct Sample
+        {
+            double mass, CS;
+            Eigen::Vector3d pos, vel, wind;
+        };
+
+        struct Outcome
+        {
+            bool hit = false;
+            Eigen::Vector2d impact = Eigen::Vector2d::Zero();
+            double tof = 0.0;
+        };
+
+        bool parseVector(const std::string& value, Eigen::Vector3d& out)
+        {
+            std::istringstream iss(value);
+            std::string s;
+            for (int i = 0; i < 3; i++)
+            {
+                if(!getline(iss, s, ',')) return false;
+                out(i) = std::stod(s);
+            }
+            return true;
+        }
+
+        std::vector<Sample> drawSamples(const Config& c)
+        {
+            std::mt19937_64 gen(c.seed);
+            std::normal_distribution<double> normal(0.0,1.0);
+            auto perturb = [&](const Eigen::Vector3d& nominal, const Eigen::Vector3d& sigma)
+            {
+                Eigen::Vector3d v;
+                for (int i = 0; i < 3; i++) v(i) = nominal(i) + sigma(i)*normal(gen);
+                return v;
+            };
+            std::vector<Sample> samples(c.count);
+            for(auto& s: samples)
+            {
+                s.mass = std::max(1e-6, c.mass + c.sigmaMass*normal(gen));
+                s.CS = std::max(0.0, c.CS + c.sigmaCS*normal(gen));
+                s.pos = perturb(c.pos, c.sigmaPos);
+                s.vel = perturb(c.vel, c.sigmaVel);
+                s.wind = perturb(c.wind, c.sigmaWind);
+            }
+            return samples;
+        }
+
+        /// @brief Scratch buffers of one thread, reused between batches
+        struct Workspace
+        {
+            Integrator integrator;
+            kernel::ForceBatch batch;
+            Eigen::VectorXd y, prev;
+            std::vector<int> sample;
+        };
+
+        /// Move realization from slot from to slot to, so realizations still in flight stay at front
+        void moveSlot(Workspace& w, int from, int to)
+        {
+            kernel::ForceBatch& batch = w.batch;
+            w.y.segment<6>(6*to) = w.y.segment<6>(6*from);
+            w.prev.segment<6>(6*to) = w.prev.segment<6>(6*from);
+            batch.wx[to] = batch.wx[from]; batch.wy[to] = batch.wy[from]; batch.wz[to] = batch.wz[from];
+            batch.mass[to] = batch.mass[from];
+            batch.CS[to] = batch.CS[from];
+            w.sample[to] = w.sample[from];
+        }
+
+        /// Integrate n realizations together until all hit ground or maxTime passes.
+        /// Realizations that hit ground are swapped out of integrated range
+        void simulateBatch(const Config& c, const Params& params, const Atmosphere& atmosphere,
+            const Sample* samples, int n, Outcome* outcomes, Workspace& w)
+        {
+            kernel::ForceBatch& batch = w.batch;
+            batch.reserve(n);
+            w.y.resize(6*n);
+            w.prev.resize(6*n);
+            w.sample.resize(n);
+            int active = 0;
+            for (int i = 0; i < n; i++)
+            {
+                const Sample& s = samples[i];
+                outcomes[i] = Outcome();
+                if(s.pos.z() >= c.groundZ)
+                {
+                    outcomes[i] = {true, s.pos.head<2>(), 0.0};
+                    continue;
+                }
+                w.y.segment<3>(6*active) = s.pos;
+                w.y.segment<3>(3+6*active) = s.vel;
+                batch.wx[active] = s.wind.x(); batch.wy[active] = s.wind.y(); batch.wz[active] = s.wind.z();
+                batch.fx[active] = 0.0; batch.fy[active] = 0.0; batch.fz[active] = 0.0;
+                batch.mass[active] = s.mass;
+                batch.CS[active] = s.CS;
+                w.sample[active] = i;
+                active++;
+            }
+            auto rhs = [&batch,&atmosphere](double, const Eigen::Ref<const Eigen::VectorXd>& y, Eigen::Ref<Eigen::VectorXd> dydt)
+            {
+                kernel::derivatives(batch,atmosphere,y,dydt,0);
+            };
+            const double h = params.STEP_TIME;
+            double t = 0.0;
+            while(active > 0 && t < c.maxTime)
+            {
+                w.prev.head(6*active) = w.y.head(6*active);
+                w.integrator.step(t, w.y.head(6*active), h, rhs);
+                t += h;
+                for (int i = 0; i < active;)
+                {
+                    const auto y = w.y.segment<6>(6*i), prev = w.prev.segment<6>(6*i);
+                    if(y(2) < c.groundZ)
+                    {
+                        i++;
+                        continue;
+                    }
+                    const double frac = (c.groundZ - prev(2))/(y(2) - prev(2));
+                    Outcome& outcome = outcomes[w.sample[i]];
+                    outcome.hit = true;
+                    outcome.impact = prev.head<2>() + frac*(y.head<2>() - prev.head<2>());
+                    outcome.tof = t - h + frac*h;
+                    moveSlot(w, --active, i);
+                }
+            }
+        }
+
+        Result aggregate(const Config& c, const std::vector<Outcome>& outcomes)
+        {
+            Result r;
+            r.count = c.count;
+            std::vector<double> tofs;
+            for(const auto& o: outcomes)
+            {
+                if(!o.hit) continue;
+                r.impacts.push_back(o.impact);
+                tofs.push_back(o.tof);
+            }
+            r.impacted = r.impacts.size();
+            r.tofHistogram.assign(std::max(1,c.histogramBins),0);
+            if(r.impacted == 0) return r;
+
+            for(const auto& p: r.impacts) r.meanImpact += p;
+            r.meanImpact /= r.impacted;
+            if(r.impacted > 1)
+            {
+                for(const auto& p: r.impacts)
+                {
+                    const Eigen::Vector2d d = p - r.meanImpact;
+                    r.covariance += d*d.transpose();
+                }
+                r.covariance /= r.impacted - 1;
+            }
+            Eigen::SelfAdjointEigenSolver<Eigen::Matrix2d> solver(r.covariance);
+            r.semiMajor = std::sqrt(std::max(0.0,solver.eigenvalues()(1)));
+            r.semiMinor = std::sqrt(std::max(0.0,solver.eigenvalues()(0)));
+            r.ellipseAngle = std::atan2(solver.eigenvectors()(1,1),solver.eigenvectors()(0,1));
+
+            std::vector<double> miss;
+            miss.reserve(r.impacted);
+            for(const auto& p: r.impacts) miss.push_back((p - r.meanImpact).norm());
+            auto median = miss.begin() + miss.size()/2;
+            std::nth_element(miss.begin(), median, miss.end());
+            r.CEP = *median;
+
+            r.tofMin = *std::min_element(tofs.begin(),tofs.end());
+            r.tofMax = *std::max_element(tofs.begin(),tofs.end());
+            double sum = 0.0;
+            for(double tof: tofs) sum += tof;
+            r.tofMean = sum/tofs.size();
+            const int bins = r.tofHistogram.size();
+            const double width = (r.tofMax - r.tofMin)/bins;
+            for(double tof: tofs)
+            {
+                int bin = width > 0.0 ? static_cast<int>((tof - r.tofMin)/width) : 0;
+                r.tofHistogram[std::min(bin,bins-1)]++;
+            }
+            return r;
+        }
+    }
+
+    bool Config::load(std::istream& in)
+    {
+        const std::map<std::string,double*> scalars = {
+            {"mass",&mass}, {"CS",&CS}, {"sigmaMass",&sigmaMass}, {"sigmaCS",&sigmaCS},
+            {"groundZ",&groundZ}, {"maxTime",&maxTime}};
+        const std::map<std::string,Eigen::Vector3d*> vectors = {
+            {"pos",&pos}, {"vel",&vel}, {"wind",&wind},
+            {"sigmaPos",&sigmaPos}, {"sigmaVel",&sigmaVel}, {"sigmaWind",&sigmaWind}};
+        std::string line;
+        while(std::getline(in, line))
+        {
+            if(line.empty() || line[0] == '#') continue;
+            const auto eq = line.find('=');
+            if(eq == std::string::npos)
+            {
+                std::cerr << "Invalid ensemble config line: " << line << std::endl;
+                return false;
+            }
+            const std::string key = line.substr(0,eq), value = line.substr(eq+1);
+            try
+            {
+                if(auto it = scalars.find(key); it != scalars.end()) *it->second = std::stod(value);
+                else if(auto it = vectors.find(key); it != vectors.end())
+                {
+                    if(!parseVector(value,*it->second)) throw std::invalid_argument(key);
+                }
+                else if(key == "count") count = std::stoi(value);
+                else if(key == "seed") seed = std::stoull(value);
+                else if(key == "threads") threads = std::stoi(value);
+                else if(key == "histogramBins") histogramBins = std::stoi(value);
+                else
+                {
+                    std::cerr << "Unknown ensemble config key: " << key << std::endl;
+                    return false;
+                }
+            }
+            catch(const std::exception&)
+            {
+                std::cerr << "Invalid ensemble config value: " << line << std::endl;
+                return false;
+            }
+        }
+        if(count <= 0)
+        {
+            std::cerr << "Ensemble count has to be positive" << std::endl;
+            return false;
+        }
+        if(threads < 0)
+        {
+            std::cerr << "Ensemble threads can not be negative" << std::endl;
+            return false;
+        }
+        if(histogramBins <= 0)
+        {
+            std::cerr << "Ensemble histogramBins has to be positive" << std::endl;
+            return false;
+        }
+        if(!(maxTime > 0.0))
+        {
+            std::cerr << "Ensemble maxTime has to be positive" << std::endl;
+            return false;
+        }
+        if(!(mass > 0.0) || !(CS >= 0.0))
+        {
+            std::cerr << "Ensemble mass has to be positive and CS can not be negative" << std::endl;
+            return false;
+        }
+        if(!(sigmaMass >= 0.0) || !(sigmaCS >= 0.0) || (sigmaPos.array() < 0.0).any()
+            || (sigmaVel.array() < 0.0).any() || (sigmaWind.array() < 0.0).any())
+        {
+            std::cerr << "Ensemble sigmas can not be negative" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    void Result::print(std::ostream& out) const
+    {
+        out << "realizations: " << count << std::endl;
+        out << "impacted: " << impacted << std::endl;
+        out << "mean impact: " << meanImpact.x() << "," << meanImpact.y() << std::endl;
+        out << "covariance: " << covariance(0,0) << "," << covariance(0,1) << "," << covariance(1,1) << std::endl;
+        out << "ellipse 1-sigma: " << semiMajor << "," << semiMinor << " angle " << ellipseAngle << std::endl;
+        out << "CEP: " << CEP << std::endl;
+        out << "time of flight: mean " << tofMean << " min " << tofMin << " max " << tofMax << std::endl;
+        const double width = tofHistogram.empty() ? 0.0 : (tofMax - tofMin)/tofHistogram.size();
+        for (size_t i = 0; i < tofHistogram.size(); i++)
+        {
+            out << tofMin + i*width << "," << tofHistogram[i] << std::endl;
+        }
+    }
+
+    bool run(const Config& config, const Params& params, Result& result)
+    {
+        if(!Integrator(params.ODE_METHOD).valid())
+        {
+            std::cerr << "Ensemble does not support ODE method " << params.ODE_METHOD << std::endl;
+            return false;
+        }
+        const Atmosphere atmosphere(params.ATMOSPHERE);
+        if(!atmosphere.valid())
+        {
+            std::cerr << "Ensemble does not support atmosphere " << params.ATMOSPHERE << std::endl;
+            return false;
+        }
+        const std::vector<Sample> samples = drawSamples(config);
+        std::vector<Outcome> outcomes(config.count);
+        const int batches = (config.count + def::ENSEMBLE_BATCH - 1)/def::ENSEMBLE_BATCH;
+        int threads = config.threads > 0 ? config.threads : std::max(1u,std::thread::hardware_concurrency());
+        ThreadPool pool(std::max(1,std::min(threads,batches)));
+        std::vector<Workspace> workspaces;
+        workspaces.reserve(pool.size());
+        for (int i = 0; i < pool.size(); i++)
+        {
+            workspaces.push_back({Integrator(params.ODE_METHOD), {}, {}, {}, {}});
+        }
+        // every pool task owns one workspace and pulls batches until none is left,
+        // so batch size, not number of threads, decides which realizations are integrated together
+        std::atomic_int nextBatch = 0;
+        auto task = [&](int self)
+        {
+            for(int b = nextBatch++; b < batches; b = nextBatch++)
+            {
+                const int first = b*def::ENSEMBLE_BATCH;
+                const int n = std::min(def::ENSEMBLE_BATCH, config.count - first);
+                simulateBatch(config, params, atmosphere, samples.data() + first, n, outcomes.data() + first,
+                    workspaces[self]);
+            }
+        };
+        pool.parallelFor(pool.size(), task);
+        result = aggregate(config, outcomes);
+        return true;
+    }
+} // namespace ensemble
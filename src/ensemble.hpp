@@ -0,0 +1,94 @@
+#pragma once
+#include <Eigen/Dense>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+#include "params.hpp"
+
+/// @brief Monte Carlo dispersion of single drop. Realizations are perturbed copies of nominal drop,
+/// integrated in batches with the same right hand side, atmosphere and integrator as live simulation,
+/// on thread pool of live simulation. Realizations that hit ground are not stepped further.
+namespace ensemble
+{
+    /// @brief Nominal drop and its perturbations. Sigmas are standard deviations of normal distributions
+    struct Config
+    {
+        /// @brief number of realizations
+        int count = 1000;
+        /// @brief seed of random generator. Results do not depend on number of threads
+        uint64_t seed = 1;
+        /// @brief number of worker threads, 0 means hardware concurrency
+        int threads = 0;
+
+        /// @brief object mass
+        double mass = 1.0;
+        /// @brief aerodynamic drag force cofficent multipled by aerodynamic field
+        double CS = 0.01;
+        /// @brief release position
+        Eigen::Vector3d pos = Eigen::Vector3d::Zero();
+        /// @brief release velocity
+        Eigen::Vector3d vel = Eigen::Vector3d::Zero();
+        /// @brief wind speed vector in m/s, constant during fall
+        Eigen::Vector3d wind = Eigen::Vector3d::Zero();
+
+        /// @brief sigma of mass
+        double sigmaMass = 0.0;
+        /// @brief sigma of CS
+        double sigmaCS = 0.0;
+        /// @brief sigma of release position, per axis
+        Eigen::Vector3d sigmaPos = Eigen::Vector3d::Zero();
+        /// @brief sigma of release velocity, per axis
+        Eigen::Vector3d sigmaVel = Eigen::Vector3d::Zero();
+        /// @brief sigma of wind, per axis
+        Eigen::Vector3d sigmaWind = Eigen::Vector3d::Zero();
+
+        /// @brief z coordinate of ground. Axis z points down, so impact is when z reaches it
+        double groundZ = 0.0;
+        /// @brief realizations that do not hit ground in this time are not counted as impacts
+        double maxTime = 120.0;
+        /// @brief number of time of flight histogram bins
+        int histogramBins = 20;
+
+        /// @brief Read config from "key=value" lines, vectors as "x,y,z". Lines starting with '#' are ignored.
+        /// Keys are the same as field names
+        /// @param in input stream
+        /// @return false if line is invalid, key is unknown or value is out of range, e.g. count is not positive
+        bool load(std::istream& in);
+    };
+
+    /// @brief Aggregated dispersion
+    struct Result
+    {
+        /// @brief number of simulated realizations
+        int count = 0;
+        /// @brief number of realizations that hit ground
+        int impacted = 0;
+        /// @brief impact points (x,y) of realizations that hit ground, in realization order
+        std::vector<Eigen::Vector2d> impacts;
+        /// @brief mean impact point
+        Eigen::Vector2d meanImpact = Eigen::Vector2d::Zero();
+        /// @brief impact point covariance
+        Eigen::Matrix2d covariance = Eigen::Matrix2d::Zero();
+        /// @brief 1-sigma covariance ellipse semi axes in m
+        double semiMajor = 0.0, semiMinor = 0.0;
+        /// @brief angle between x axis and major axis of ellipse in rad
+        double ellipseAngle = 0.0;
+        /// @brief circular error probable, radius around mean impact point containing half of impacts
+        double CEP = 0.0;
+        /// @brief time of flight statistics in s
+        double tofMean = 0.0, tofMin = 0.0, tofMax = 0.0;
+        /// @brief time of flight histogram, bins of equal width between tofMin and tofMax
+        std::vector<int> tofHistogram;
+
+        /// @brief Print human readable summary
+        /// @param out output stream
+        void print(std::ostream& out) const;
+    };
+
+    /// @brief Run ensemble
+    /// @param config nominal drop and perturbations
+    /// @param params simulation params, STEP_TIME, ODE_METHOD and ATMOSPHERE are used
+    /// @param result output, aggregated statistics
+    /// @return false if ODE method or atmosphere is not supported
+    bool run(const Config& config, const Params& params, Result& result);
+} // namespace ensemble
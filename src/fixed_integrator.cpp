@@ -0,0 +1,17 @@
+#include "fixed_integrator.hpp"
+
+namespace fixed
+{
+    std::optional<Method> fromString(const std::string& name)
+    {
+        if(name == "Euler") return Stepper<Euler>{};
+        if(name == "Midpoint") return Stepper<Midpoint>{};
+        if(name == "Heun") return Stepper<Heun>{};
+        if(name == "Ralston") return Stepper<Ralston>{};
+        if(name == "RK3") return Stepper<RK3>{};
+        if(name == "SSPRK3") return Stepper<SSPRK3>{};
+        if(name == "RK4") return Stepper<RK4>{};
+        if(name == "RK38") return Stepper<RK38>{};
+        return std::nullopt;
+    }
+} // namespace fixed
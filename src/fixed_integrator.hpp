@@ -0,0 +1,112 @@
+#pragma once
+#include <Eigen/Dense>
+#include <array>
+#include <optional>
+#include <string>
+#include <utility>
+#include <variant>
+#include "force_kernel.hpp"
+#include "integrator.hpp"
+
+/// @brief Explicit Runge-Kutta methods specialized at compile time for state of single object.
+/// Tableau is template parameter, so stages are unrolled, zero cofficents vanish and RHS is inlined
+/// while 6-vector of object stays in registers. Tableaux are shared with Integrator (see butcher namespace).
+/// Used by single object lookahead of ImpactPredictor, engine integrates all objects together by Integrator.
+namespace fixed
+{
+    /// @brief State of single object, position and velocity
+    using Vector6d = Eigen::Matrix<double,6,1>;
+
+    /// @brief Method with tableau known at compile time
+    /// @tparam Tab tableau from butcher namespace
+    template<const Integrator::Tableau& Tab>
+    struct Butcher
+    {
+        static constexpr int stages = Tab.stages;
+        static constexpr const Integrator::Tableau& tableau = Tab;
+    };
+
+    struct Euler : Butcher<butcher::euler> {};
+    struct Midpoint : Butcher<butcher::midpoint> {};
+    struct Heun : Butcher<butcher::heun> {};
+    struct Ralston : Butcher<butcher::ralston> {};
+    struct RK3 : Butcher<butcher::rk3> {};
+    struct SSPRK3 : Butcher<butcher::ssprk3> {};
+    struct RK4 : Butcher<butcher::rk4> {};
+    struct RK38 : Butcher<butcher::rk38> {};
+
+    /// @brief Inputs of motion equations of single object, constant during step
+    struct Inputs
+    {
+        Eigen::Vector3d wind;
+        Eigen::Vector3d force;
+        double mass;
+        double CS;
+        double airDensity;
+    };
+
+    /// @brief Right hand side of motion equations of single object, same formula as force kernel
+    /// @param y object state
+    /// @param in inputs of object
+    /// @return derivative of state
+    inline Vector6d derivative(const Vector6d& y, const Inputs& in)
+    {
+        Vector6d dydt;
+        dydt.head<3>() = y.tail<3>();
+        dydt.tail<3>() = kernel::acceleration(y.tail<3>(), in.wind, in.force, in.mass, in.CS, in.airDensity);
+        return dydt;
+    }
+
+    /// @brief Argument of RHS in stage S
+    template<typename M, int S>
+    inline Vector6d stage(const Vector6d& y, double h, const std::array<Vector6d,M::stages>& k)
+    {
+        Vector6d res = y;
+        [&]<int... J>(std::integer_sequence<int,J...>)
+        {
+            ((M::tableau.a[S][J] != 0.0 ? (void)(res += (h*M::tableau.a[S][J])*k[J]) : (void)0), ...);
+        }(std::make_integer_sequence<int,S>{});
+        return res;
+    }
+
+    /// @brief Make one step of method M. Same order of operations as Integrator
+    /// @param y object state, overwritten with state after step
+    /// @param h step time
+    /// @param f right hand side, called as f(y). Should return derivative
+    template<typename M, typename F>
+    inline void step(Vector6d& y, double h, F&& f)
+    {
+        std::array<Vector6d,M::stages> k;
+        [&]<int... S>(std::integer_sequence<int,S...>)
+        {
+            ((k[S] = f(stage<M,S>(y,h,k))), ...);
+            ((M::tableau.b[S] != 0.0 ? (void)(y += (h*M::tableau.b[S])*k[S]) : (void)0), ...);
+        }(std::make_integer_sequence<int,M::stages>{});
+    }
+
+    /// @brief Method M bound as value, alternative of Method variant
+    template<typename M>
+    struct Stepper
+    {
+        static constexpr int stages = M::stages;
+
+        /// @brief Make one step of method
+        /// @param y object state, overwritten with state after step
+        /// @param h step time
+        /// @param f right hand side, called as f(y). Should return derivative
+        template<typename F>
+        inline void operator()(Vector6d& y, double h, F&& f) const
+        {
+            step<M>(y,h,f);
+        }
+    };
+
+    /// @brief Any fixed method. Visited once per step, so loop over objects is compiled for each method
+    using Method = std::variant<Stepper<Euler>, Stepper<Midpoint>, Stepper<Heun>, Stepper<Ralston>,
+        Stepper<RK3>, Stepper<SSPRK3>, Stepper<RK4>, Stepper<RK38>>;
+
+    /// @brief Get method by name
+    /// @param name name of ODE method, same as used by ODE::fromString
+    /// @return method, empty if name is not known
+    std::optional<Method> fromString(const std::string& name);
+} // namespace fixed
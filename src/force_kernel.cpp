@@ -0,0 +1,182 @@
+#include <cmath>
+#include "force_kernel.hpp"
+#include "defines.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define DROP_KERNEL_X86
+#include <immintrin.h>
+#endif
+
+namespace kernel
+{
+    void ForceBatch::reserve(int n)
+    {
+        if(static_cast<int>(mass.size()) >= n) return;
+        for(auto* buffer: {&vx,&vy,&vz,&wx,&wy,&wz,&fx,&fy,&fz,&mass,&CS,&altitude,&rho,&ax,&ay,&az})
+        {
+            buffer->resize(n);
+        }
+    }
+
+    /// Single object, same operations order as vectorized version
+    static inline void accelerationAt(ForceBatch& b, int i, double halfDensity)
+    {
+        const double dx = b.vx[i] - b.wx[i];
+        const double dy = b.vy[i] - b.wy[i];
+        const double dz = b.vz[i] - b.wz[i];
+        const double d2 = dx*dx + dy*dy + dz*dz;
+        const double q = halfDensity*d2;
+        double drag_x = 0.0, drag_y = 0.0, drag_z = 0.0;
+        if(q != 0.0)
+        {
+            const double norm = std::sqrt(d2);
+            const double coff = -b.CS[i]*q;
+            drag_x = coff*(dx/norm);
+            drag_y = coff*(dy/norm);
+            drag_z = coff*(dz/norm);
+        }
+        const double m = b.mass[i];
+        b.ax[i] = (drag_x + b.fx[i])/m;
+        b.ay[i] = (drag_y + b.fy[i])/m;
+        b.az[i] = (m*def::GRAVITY_CONST + drag_z + b.fz[i])/m;
+    }
+
+    /// Density of all objects is airDensity, or batch.rho if PerObject
+    template<bool PerObject>
+    static inline void scalarRange(ForceBatch& batch, int first, int last, double airDensity)
+    {
+        const double halfDensity = 0.5*airDensity;
+        for (int i = first; i < last; i++)
+        {
+            accelerationAt(batch,i,PerObject ? 0.5*batch.rho[i] : halfDensity);
+        }
+    }
+
+    void accelerationsScalar(ForceBatch& batch, int first, int last, double airDensity)
+    {
+        scalarRange<false>(batch,first,last,airDensity);
+    }
+
+    void accelerationsScalar(ForceBatch& batch, int first, int last)
+    {
+        scalarRange<true>(batch,first,last,0.0);
+    }
+
+#ifdef DROP_KERNEL_X86
+    template<bool PerObject>
+    __attribute__((target("avx2")))
+    static inline void avx2Range(ForceBatch& b, int first, int last, double airDensity)
+    {
+        const double halfDensity = 0.5*airDensity;
+        const __m256d half = _mm256_set1_pd(0.5);
+        const __m256d g = _mm256_set1_pd(def::GRAVITY_CONST);
+        const __m256d zero = _mm256_setzero_pd();
+        int i = first;
+        for (; i + 4 <= last; i += 4)
+        {
+            const __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(&b.vx[i]),_mm256_loadu_pd(&b.wx[i]));
+            const __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(&b.vy[i]),_mm256_loadu_pd(&b.wy[i]));
+            const __m256d dz = _mm256_sub_pd(_mm256_loadu_pd(&b.vz[i]),_mm256_loadu_pd(&b.wz[i]));
+            const __m256d d2 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx,dx),_mm256_mul_pd(dy,dy)),_mm256_mul_pd(dz,dz));
+            const __m256d half_rho = PerObject ? _mm256_mul_pd(half,_mm256_loadu_pd(&b.rho[i])) : _mm256_set1_pd(halfDensity);
+            const __m256d q = _mm256_mul_pd(half_rho,d2);
+            const __m256d moving = _mm256_cmp_pd(q,zero,_CMP_NEQ_OQ);
+            const __m256d norm = _mm256_sqrt_pd(d2);
+            const __m256d coff = _mm256_mul_pd(_mm256_sub_pd(zero,_mm256_loadu_pd(&b.CS[i])),q);
+            const __m256d drag_x = _mm256_and_pd(moving,_mm256_mul_pd(coff,_mm256_div_pd(dx,norm)));
+            const __m256d drag_y = _mm256_and_pd(moving,_mm256_mul_pd(coff,_mm256_div_pd(dy,norm)));
+            const __m256d drag_z = _mm256_and_pd(moving,_mm256_mul_pd(coff,_mm256_div_pd(dz,norm)));
+            const __m256d m = _mm256_loadu_pd(&b.mass[i]);
+            _mm256_storeu_pd(&b.ax[i],_mm256_div_pd(_mm256_add_pd(drag_x,_mm256_loadu_pd(&b.fx[i])),m));
+            _mm256_storeu_pd(&b.ay[i],_mm256_div_pd(_mm256_add_pd(drag_y,_mm256_loadu_pd(&b.fy[i])),m));
+            _mm256_storeu_pd(&b.az[i],_mm256_div_pd(
+                _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(m,g),drag_z),_mm256_loadu_pd(&b.fz[i])),m));
+        }
+        scalarRange<PerObject>(b,i,last,airDensity);
+    }
+
+    void accelerationsAVX2(ForceBatch& batch, int first, int last, double airDensity)
+    {
+        avx2Range<false>(batch,first,last,airDensity);
+    }
+
+    void accelerationsAVX2(ForceBatch& batch, int first, int last)
+    {
+        avx2Range<true>(batch,first,last,0.0);
+    }
+
+    bool hasAVX2()
+    {
+        static const bool supported = __builtin_cpu_supports("avx2");
+        return supported;
+    }
+#else
+    void accelerationsAVX2(ForceBatch& batch, int first, int last, double airDensity)
+    {
+        accelerationsScalar(batch,first,last,airDensity);
+    }
+
+    void accelerationsAVX2(ForceBatch& batch, int first, int last)
+    {
+        accelerationsScalar(batch,first,last);
+    }
+
+    bool hasAVX2()
+    {
+        return false;
+    }
+#endif
+
+    void accelerations(ForceBatch& batch, int first, int last, double airDensity)
+    {
+        if(hasAVX2())
+        {
+            accelerationsAVX2(batch,first,last,airDensity);
+        }
+        else
+        {
+            accelerationsScalar(batch,first,last,airDensity);
+        }
+    }
+
+    void accelerations(ForceBatch& batch, int first, int last)
+    {
+        if(hasAVX2())
+        {
+            accelerationsAVX2(batch,first,last);
+        }
+        else
+        {
+            accelerationsScalar(batch,first,last);
+        }
+    }
+
+    void derivatives(ForceBatch& batch, const Atmosphere& atmosphere, const Eigen::Ref<const Eigen::VectorXd>& y,
+        Eigen::Ref<Eigen::VectorXd> dydt, int first)
+    {
+        const int no = y.size()/6;
+        for (int i = 0; i < no; i++)
+        {
+            batch.altitude[first+i] = -y(2+6*i);
+            batch.vx[first+i] = y(3+6*i);
+            batch.vy[first+i] = y(4+6*i);
+            batch.vz[first+i] = y(5+6*i);
+            dydt.segment<3>(6*i) = y.segment<3>(3+6*i);
+        }
+        if(atmosphere.constant())
+        {
+            accelerations(batch,first,first+no,atmosphere.density(0.0));
+        }
+        else
+        {
+            atmosphere.densities(&batch.altitude[first],&batch.rho[first],no);
+            accelerations(batch,first,first+no);
+        }
+        for (int i = 0; i < no; i++)
+        {
+            dydt(3+6*i) = batch.ax[first+i];
+            dydt(4+6*i) = batch.ay[first+i];
+            dydt(5+6*i) = batch.az[first+i];
+        }
+    }
+} // namespace kernel
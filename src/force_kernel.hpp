@@ -0,0 +1,123 @@
+#pragma once
+#include <vector>
+#include <cmath>
+#include <Eigen/Dense>
+#include "defines.hpp"
+#include "atmosphere.hpp"
+
+/// @brief Batched drag, gravity and outer force evaluation over many objects
+namespace kernel
+{
+    /// @brief Structure of arrays with inputs and outputs of force kernel.
+    /// Buffers are reused between calls, reserve is needed only when object count grows.
+    struct ForceBatch
+    {
+        /// @brief object velocity in m/s
+        std::vector<double> vx, vy, vz;
+        /// @brief wind speed in m/s
+        std::vector<double> wx, wy, wz;
+        /// @brief outer force in N
+        std::vector<double> fx, fy, fz;
+        /// @brief object mass
+        std::vector<double> mass;
+        /// @brief aerodynamic drag force cofficent multipled by aerodynamic field
+        std::vector<double> CS;
+        /// @brief object altitude in m, input of atmosphere model
+        std::vector<double> altitude;
+        /// @brief air density at object in kg/m3, used by kernels without density argument
+        std::vector<double> rho;
+        /// @brief output, acceleration in m/s2
+        std::vector<double> ax, ay, az;
+
+        /// @brief Resize all buffers to hold at least n objects
+        /// @param n number of objects
+        void reserve(int n);
+    };
+
+    /// @brief Acceleration of single object, same formula as batched kernel
+    /// @param vel object velocity in m/s
+    /// @param wind wind speed in m/s
+    /// @param force outer force in N
+    /// @param mass object mass
+    /// @param CS aerodynamic drag force cofficent multipled by aerodynamic field
+    /// @param airDensity air density in kg/m3
+    /// @return acceleration in m/s2
+    inline Eigen::Vector3d acceleration(const Eigen::Vector3d& vel, const Eigen::Vector3d& wind,
+        const Eigen::Vector3d& force, double mass, double CS, double airDensity)
+    {
+        const Eigen::Vector3d diff = vel - wind;
+        const double d2 = diff.squaredNorm();
+        const double q = 0.5*airDensity*d2;
+        Eigen::Vector3d drag = Eigen::Vector3d::Zero();
+        if(q != 0.0)
+        {
+            drag = (-CS*q)*(diff/std::sqrt(d2));
+        }
+        return Eigen::Vector3d((drag.x() + force.x())/mass, (drag.y() + force.y())/mass,
+            (mass*def::GRAVITY_CONST + drag.z() + force.z())/mass);
+    }
+
+    /// @brief Calculate accelerations of objects with indices in [first, last). Uses fastest implementation available on CPU.
+    /// Vector lanes are counted from first, so result of object does not depend on other objects in range
+    /// as long as first is multiple of 4
+    /// @param batch inputs and outputs
+    /// @param first index of first object
+    /// @param last index after last object
+    /// @param airDensity air density in kg/m3
+    void accelerations(ForceBatch& batch, int first, int last, double airDensity);
+
+    /// @brief Portable implementation of accelerations
+    void accelerationsScalar(ForceBatch& batch, int first, int last, double airDensity);
+
+    /// @brief AVX2 implementation of accelerations. Must be called only if hasAVX2() is true
+    void accelerationsAVX2(ForceBatch& batch, int first, int last, double airDensity);
+
+    /// @brief Calculate accelerations of objects with indices in [first, last), each in air density from batch.rho.
+    /// Uses fastest implementation available on CPU
+    /// @param batch inputs and outputs
+    /// @param first index of first object
+    /// @param last index after last object
+    void accelerations(ForceBatch& batch, int first, int last);
+
+    /// @brief Portable implementation of accelerations with density of objects
+    void accelerationsScalar(ForceBatch& batch, int first, int last);
+
+    /// @brief AVX2 implementation of accelerations with density of objects. Must be called only if hasAVX2() is true
+    void accelerationsAVX2(ForceBatch& batch, int first, int last);
+
+    /// @brief Calculate accelerations of first n objects in batch
+    /// @param batch inputs and outputs
+    /// @param n number of objects
+    /// @param airDensity air density in kg/m3
+    inline void accelerations(ForceBatch& batch, int n, double airDensity)
+    {
+        accelerations(batch,0,n,airDensity);
+    }
+
+    /// @brief Portable implementation of accelerations of first n objects
+    inline void accelerationsScalar(ForceBatch& batch, int n, double airDensity)
+    {
+        accelerationsScalar(batch,0,n,airDensity);
+    }
+
+    /// @brief AVX2 implementation of accelerations of first n objects. Must be called only if hasAVX2() is true
+    inline void accelerationsAVX2(ForceBatch& batch, int n, double airDensity)
+    {
+        accelerationsAVX2(batch,0,n,airDensity);
+    }
+
+    /// @brief Right hand side of motion equations of consecutive objects, each stored in y as position and velocity.
+    /// Gathers velocities and altitudes into batch from index first, evaluates kernel in density of atmosphere
+    /// and scatters accelerations. Wind, outer force, mass and CS of objects have to be set in batch before
+    /// @param batch inputs and outputs, objects of y are at [first, first + y.size()/6)
+    /// @param atmosphere air density source
+    /// @param y state of objects
+    /// @param dydt output, derivative of state
+    /// @param first index of first object in batch
+    void derivatives(ForceBatch& batch, const Atmosphere& atmosphere, const Eigen::Ref<const Eigen::VectorXd>& y,
+        Eigen::Ref<Eigen::VectorXd> dydt, int first);
+
+    /// @brief Check if CPU supports AVX2
+    /// @return true if AVX2 kernel can be used
+    bool hasAVX2();
+} // namespace kernel
@@ -0,0 +1,182 @@
+#include <chrono>
+#include "impact_predictor.hpp"
+#include "defines.hpp"
+
+ImpactPredictor::ImpactPredictor(double stepTime, const std::string& method, const Atmosphere& atmosphere,
+    const WindField& windField)
+    : stepTime{stepTime}, method{fixed::fromString(method).value_or(fixed::Stepper<fixed::RK4>{})},
+    atmosphere{atmosphere}, windField{windField}, running{true}
+{
+    worker = std::thread(&ImpactPredictor::workerLoop, this);
+}
+
+ImpactPredictor::~ImpactPredictor()
+{
+    {
+        std::scoped_lock lock(mtx);
+        running = false;
+    }
+    jobsCv.notify_all();
+    if(worker.joinable())
+    {
+        worker.join();
+    }
+}
+
+bool ImpactPredictor::query(int id, double groundZ, Prediction& prediction)
+{
+    std::unique_lock lock(mtx);
+    auto it = cache.find(id);
+    if(it == cache.end())
+    {
+        it = cache.emplace(id, Entry{groundZ, false, false, 0, false, Eigen::Vector3d::Zero(), Prediction()}).first;
+    }
+    else if(it->second.groundZ != groundZ)
+    {
+        it->second.groundZ = groundZ;
+        restart(it->second);
+    }
+    // entry is dropped if object is removed or does not exist
+    const bool ready = readyCv.wait_for(lock, std::chrono::milliseconds(def::PREDICTION_TIMEOUT_MS), [this,id]()
+    {
+        auto it = cache.find(id);
+        return it == cache.end() || it->second.ready;
+    });
+    if(!ready) return false;
+    it = cache.find(id);
+    prediction = it == cache.end() ? Prediction() : it->second.prediction;
+    return true;
+}
+
+void ImpactPredictor::invalidate(const std::vector<int>& ids)
+{
+    std::scoped_lock lock(mtx);
+    for(int id: ids)
+    {
+        auto it = cache.find(id);
+        if(it != cache.end()) restart(it->second);
+    }
+}
+
+void ImpactPredictor::forget(int id)
+{
+    {
+        std::scoped_lock lock(mtx);
+        if(cache.erase(id) == 0) return;
+    }
+    readyCv.notify_all();
+}
+
+size_t ImpactPredictor::size()
+{
+    std::scoped_lock lock(mtx);
+    return cache.size();
+}
+
+void ImpactPredictor::restart(Entry& entry)
+{
+    entry.ready = false;
+    entry.seeded = false;
+    entry.generation++;
+}
+
+void ImpactPredictor::update(State& state)
+{
+    std::unique_lock lock(mtx, std::try_to_lock);
+    if(!lock.owns_lock()) return;
+    bool newJobs = false, newResults = false;
+    for(auto it = cache.begin(); it != cache.end();)
+    {
+        auto& [id, entry] = *it;
+        const int index = state.findIndex(id);
+        if(index < 0)
+        {
+            it = cache.erase(it);
+            newResults = true;
+            continue;
+        }
+        const ObjParams* p = state.getParams(index);
+        if(entry.seeded && entry.ready && (p->hasWind() != entry.windSet || (entry.windSet && p->getWind() != entry.wind)))
+        {
+            restart(entry);
+        }
+        ++it;
+        if(entry.seeded) continue;
+        entry.seeded = true;
+        entry.windSet = p->hasWind();
+        entry.wind = p->getWind();
+        jobs.push_back({id, entry.generation, entry.groundZ, state.real_time, p->mass, p->CS_coff,
+            entry.windSet, state.getPos(index), state.getVel(index), entry.wind});
+        newJobs = true;
+    }
+    lock.unlock();
+    if(newJobs) jobsCv.notify_one();
+    if(newResults) readyCv.notify_all();
+}
+
+void ImpactPredictor::workerLoop()
+{
+    std::vector<Job> local;
+    std::vector<Prediction> results;
+    std::unique_lock lock(mtx);
+    while(true)
+    {
+        jobsCv.wait(lock, [this]() {return !jobs.empty() || !running;});
+        if(!running) break;
+        local.swap(jobs);
+        lock.unlock();
+        results.clear();
+        for(const auto& job: local)
+        {
+            results.push_back(lookahead(job));
+        }
+        lock.lock();
+        for (size_t i = 0; i < local.size(); i++)
+        {
+            auto it = cache.find(local[i].id);
+            if(it == cache.end() || it->second.generation != local[i].generation) continue;
+            it->second.prediction = results[i];
+            it->second.ready = true;
+        }
+        local.clear();
+        readyCv.notify_all();
+    }
+}
+
+ImpactPredictor::Prediction ImpactPredictor::lookahead(const Job& job) const
+{
+    using fixed::Vector6d;
+    fixed::Inputs inputs{job.wind, Eigen::Vector3d::Zero(), job.mass, job.CS, atmosphere.density(0.0)};
+    Vector6d y;
+    y << job.pos, job.vel;
+    if(y(2) >= job.groundZ)
+    {
+        return {true, job.time, job.pos, job.vel};
+    }
+    const double h = stepTime;
+    const int steps = def::PREDICTION_HORIZON/h;
+    const bool field = windField.loaded() && !job.windSet;
+    auto rhs = [&](const Vector6d& s)
+    {
+        if(!atmosphere.constant()) inputs.airDensity = atmosphere.density(-s(2));
+        return fixed::derivative(s,inputs);
+    };
+    return std::visit([&](const auto& stepper)
+    {
+        for (int i = 0; i < steps; i++)
+        {
+            // the same as Engine::captureInputs, field is sampled once per step at start position
+            if(field) inputs.wind = windField.at(job.time + i*h)(y.head<3>());
+            Vector6d next = y;
+            stepper(next, h, rhs);
+            if(next(2) >= job.groundZ)
+            {
+                const double frac = (job.groundZ - y(2))/(next(2) - y(2));
+                const Vector6d hit = y + frac*(next - y);
+                return Prediction{true, job.time + (i + frac)*h, hit.head<3>(), hit.tail<3>()};
+            }
+            y = next;
+        }
+        return Prediction{};
+    }, method);
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include <Eigen/Dense>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "state.hpp"
+#include "fixed_integrator.hpp"
+#include "atmosphere.hpp"
+#include "wind_field.hpp"
+
+/// @brief Predicts where and when objects hit ground plane. Lookahead integration runs on worker thread
+/// with the same wind and air density sources as engine: wind set for object or wind field sampled once
+/// per step at object position, and density of atmosphere at altitude of every stage.
+/// Result is cached per object until object's wind changes or its velocity is changed by command or engine.
+/// Entries of removed objects are dropped. Outer forces are assumed to expire, so prediction is made without them.
+class ImpactPredictor
+{
+    public:
+        /// @brief Predicted impact
+        struct Prediction
+        {
+            /// @brief false if object does not exist or does not hit ground within def::PREDICTION_HORIZON
+            bool hit = false;
+            /// @brief simulation time of impact in s
+            double time = 0.0;
+            /// @brief impact position
+            Eigen::Vector3d pos = Eigen::Vector3d::Zero();
+            /// @brief impact velocity
+            Eigen::Vector3d vel = Eigen::Vector3d::Zero();
+        };
+
+        /// @brief Constructor. Starts worker thread
+        /// @param stepTime step of lookahead integration in s
+        /// @param method name of fixed step ODE method of lookahead. RK4 is used if method has no fixed step variant
+        /// @param atmosphere air density source, e.g. of engine. Must outlive predictor
+        /// @param windField wind field of objects without own wind, e.g. of engine. Must outlive predictor and stay loaded
+        ImpactPredictor(double stepTime, const std::string& method, const Atmosphere& atmosphere, const WindField& windField);
+
+        ImpactPredictor(const ImpactPredictor&) = delete; // no copies
+        ImpactPredictor& operator=(const ImpactPredictor&) = delete; // no self-assignments
+
+        /// @brief Deconstructor. Stops worker thread
+        ~ImpactPredictor();
+
+        /// @brief Get prediction for object. Returns immediately if prediction is cached,
+        /// otherwise waits up to def::PREDICTION_TIMEOUT_MS for simulation and worker thread. Thread safe
+        /// @param id object id
+        /// @param groundZ z coordinate of ground plane, axis z points down
+        /// @param prediction output
+        /// @return false if prediction is not ready in time
+        bool query(int id, double groundZ, Prediction& prediction);
+
+        /// @brief Drop cached predictions of objects, e.g. after collision or new outer force.
+        /// Takes lock once for all objects, so should be called by simulation thread once per step
+        /// @param ids object ids, unknown ids are ignored
+        void invalidate(const std::vector<int>& ids);
+
+        /// @brief Drop cache entry of removed object. Pending query of object reports no hit.
+        /// Should be called by simulation thread
+        /// @param id object id
+        void forget(int id);
+
+        /// @brief Get number of cached objects
+        size_t size();
+
+        /// @brief Pass states of queried and invalidated objects to worker thread.
+        /// Should be called by simulation thread at step boundary. Never blocks, if predictor is busy
+        /// work is postponed to next step
+        /// @param state simulation state
+        void update(State& state);
+
+    private:
+        struct Entry
+        {
+            double groundZ;
+            bool ready;
+            bool seeded;
+            unsigned generation;
+            bool windSet;
+            Eigen::Vector3d wind;
+            Prediction prediction;
+        };
+
+        struct Job
+        {
+            int id;
+            unsigned generation;
+            double groundZ, time, mass, CS;
+            bool windSet;
+            Eigen::Vector3d pos, vel, wind;
+        };
+
+        const double stepTime;
+        const fixed::Method method;
+        const Atmosphere& atmosphere;
+        const WindField& windField;
+        std::mutex mtx;
+        std::condition_variable readyCv;
+        std::condition_variable jobsCv;
+        std::unordered_map<int,Entry> cache;
+        std::vector<Job> jobs;
+        bool running;
+        std::thread worker;
+
+        void restart(Entry& entry);
+        void workerLoop();
+        Prediction lookahead(const Job& job) const;
+};
@@ -0,0 +1,34 @@
+#include <map>
+#include "integrator.hpp"
+
+namespace
+{
+    using T = Integrator::Tableau;
+
+    const std::map<std::string,const T*> methods = {
+        {"Euler", &butcher::euler},
+        {"Midpoint", &butcher::midpoint},
+        {"Heun", &butcher::heun},
+        {"Ralston", &butcher::ralston},
+        {"RK3", &butcher::rk3},
+        {"SSPRK3", &butcher::ssprk3},
+        {"RK4", &butcher::rk4},
+        {"RK38", &butcher::rk38}
+    };
+}
+
+Integrator::Integrator(const std::string& method)
+{
+    auto iter = methods.find(method);
+    tableau = iter == methods.end() ? nullptr : iter->second;
+}
+
+void Integrator::reserve(int size)
+{
+    if(tmp.size() >= size) return;
+    for(auto& stage: k)
+    {
+        stage.setZero(size);
+    }
+    tmp.setZero(size);
+}
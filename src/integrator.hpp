@@ -0,0 +1,112 @@
+#pragma once
+#include <Eigen/Dense>
+#include <string>
+#include <array>
+#include <vector>
+
+/// @brief Explicit Runge-Kutta integrator that steps state in place.
+/// Stage buffers are owned by integrator and reused between steps, so step does not allocate
+/// as long as state does not outgrow reserved size.
+class Integrator
+{
+    public:
+        /// @brief Maximal number of stages supported by tableau
+        static constexpr int MAX_STAGES = 4;
+
+        /// @brief Butcher tableau of explicit method
+        struct Tableau
+        {
+            int stages;
+            std::array<std::array<double,MAX_STAGES>,MAX_STAGES> a;
+            std::array<double,MAX_STAGES> b;
+            std::array<double,MAX_STAGES> c;
+        };
+
+        /// @brief Constructor
+        /// @param method name of ODE method, same as used by ODE::fromString
+        Integrator(const std::string& method);
+
+        /// @brief Check if method is supported by in place integrator
+        /// @return true if method is known
+        inline bool valid() const {return tableau != nullptr;}
+
+        /// @brief Get number of RHS evaluations in one step
+        /// @return number of stages
+        inline int getStages() const {return tableau->stages;}
+
+        /// @brief Preallocate stage buffers
+        /// @param size maximal size of integrated state
+        void reserve(int size);
+
+        /// @brief Make one step of integration
+        /// @param t time at the beginning of step
+        /// @param y state, overwritten with state at t + h
+        /// @param h step time
+        /// @param f right hand side, called as f(t, y, dydt). Should write derivative into dydt
+        template<typename F>
+        void step(double t, Eigen::Ref<Eigen::VectorXd> y, double h, F&& f)
+        {
+            reserve(y.size());
+            stepSegment(t, y, 0, h, f);
+        }
+
+        /// @brief Make one step of integration of independent part of state.
+        /// Uses stage buffers at the same offset as part, so non overlapping parts can be stepped concurrently.
+        /// Buffers must be reserved before
+        /// @param t time at the beginning of step
+        /// @param y part of state, overwritten with state at t + h
+        /// @param offset index of first element of part in whole state
+        /// @param h step time
+        /// @param f right hand side of part, called as f(t, y, dydt). Should write derivative into dydt
+        template<typename F>
+        void stepSegment(double t, Eigen::Ref<Eigen::VectorXd> y, int offset, double h, F&& f)
+        {
+            const int n = y.size();
+            if(n == 0) return;
+            const Tableau& tab = *tableau;
+            f(t, y, k[0].segment(offset,n));
+            for (int s = 1; s < tab.stages; s++)
+            {
+                auto stage = tmp.segment(offset,n);
+                stage = y;
+                for (int j = 0; j < s; j++)
+                {
+                    if(tab.a[s][j] != 0.0) stage += (h*tab.a[s][j])*k[j].segment(offset,n);
+                }
+                f(t + tab.c[s]*h, stage, k[s].segment(offset,n));
+            }
+            for (int s = 0; s < tab.stages; s++)
+            {
+                if(tab.b[s] != 0.0) y += (h*tab.b[s])*k[s].segment(offset,n);
+            }
+        }
+
+    private:
+        const Tableau* tableau;
+        std::array<Eigen::VectorXd,MAX_STAGES> k;
+        Eigen::VectorXd tmp;
+};
+
+/// @brief Butcher tableaux of explicit methods. Single definition used by Integrator and by fixed steppers
+namespace butcher
+{
+    using T = Integrator::Tableau;
+
+    inline constexpr T euler{1, {{{0.0}}}, {1.0}, {0.0}};
+
+    inline constexpr T midpoint{2, {{{0.0}, {0.5}}}, {0.0, 1.0}, {0.0, 0.5}};
+
+    inline constexpr T heun{2, {{{0.0}, {1.0}}}, {0.5, 0.5}, {0.0, 1.0}};
+
+    inline constexpr T ralston{2, {{{0.0}, {2.0/3.0}}}, {0.25, 0.75}, {0.0, 2.0/3.0}};
+
+    inline constexpr T rk3{3, {{{0.0}, {0.5}, {-1.0, 2.0}}}, {1.0/6.0, 2.0/3.0, 1.0/6.0}, {0.0, 0.5, 1.0}};
+
+    inline constexpr T ssprk3{3, {{{0.0}, {1.0}, {0.25, 0.25}}}, {1.0/6.0, 1.0/6.0, 2.0/3.0}, {0.0, 1.0, 0.5}};
+
+    inline constexpr T rk4{4, {{{0.0}, {0.5}, {0.0, 0.5}, {0.0, 0.0, 1.0}}},
+        {1.0/6.0, 1.0/3.0, 1.0/3.0, 1.0/6.0}, {0.0, 0.5, 0.5, 1.0}};
+
+    inline constexpr T rk38{4, {{{0.0}, {1.0/3.0}, {-1.0/3.0, 1.0}, {1.0, -1.0, 1.0}}},
+        {1.0/8.0, 3.0/8.0, 3.0/8.0, 1.0/8.0}, {0.0, 1.0/3.0, 2.0/3.0, 1.0}};
+} // namespace butcher
@@ -1,9 +1,15 @@
 #include <iostream>
+#include <fstream>
 #include <Eigen/Dense>
 #include <cxxopts.hpp>
 #include "simulation.hpp"
 #include "common.hpp"
 #include "params.hpp"
+#include "async_logger.hpp"
+#include "offline_runner.hpp"
+#include "ensemble.hpp"
+#include "topic_publisher.hpp"
+#include "output_streams.hpp"
 
 /// @brief Parse CL arguments
 /// @param argc number of argument
@@ -14,7 +20,23 @@ void parseArgs(int argc, char** argv, Params& p)
     cxxopts::Options options("drop", "Physic engine for non-propelled objects");
     options.add_options()
         ("dt", "Step time of simulation in ms. Default: 3 ms", cxxopts::value<int>())
-        ("o,ode", "ODE solver. Defaulf: RK4", cxxopts::value<std::string>())
+        ("o,ode", "ODE solver, DOPRI5 for adaptive step. Defaulf: RK4", cxxopts::value<std::string>())
+        ("state-format", "Published state format: text, binary or both. Binary frames are published on state_bin. Default: text", cxxopts::value<std::string>())
+        ("log-overflow", "Trajectory log policy when disk can not keep up: drop, block or decimate. Default: drop", cxxopts::value<std::string>())
+        ("offline", "Run scenario file as fast as possible, without sockets", cxxopts::value<std::string>())
+        ("output", "Trajectory output file, requires offline. Default: stdout", cxxopts::value<std::string>())
+        ("duration", "Maximal simulated time in s, requires offline. Default: 60 s", cxxopts::value<double>())
+        ("ensemble", "Run Monte Carlo drop ensemble described by config file and print impact statistics", cxxopts::value<std::string>())
+        ("threads", "Number of threads integrating large swarms, 0 for all cores. Default: 0", cxxopts::value<int>())
+        ("terrain", "Terrain index file. Objects collide with ground without external simulator", cxxopts::value<std::string>())
+        ("wind-field", "Gridded time-varying wind field file. Wind set by message overrides it", cxxopts::value<std::string>())
+        ("atmosphere", "Atmosphere model of drag: constant, ISA", cxxopts::value<std::string>())
+        ("shm-ring", "Also publish binary state to shared memory ring of this name, e.g. /drop_shot_state", cxxopts::value<std::string>())
+        ("state-topics", "Also publish state split by object and region topics on state_topics")
+        ("regions", "Regions of topic endpoint: name,xmin,ymin,zmin,xmax,ymax,zmax separated by ';'", cxxopts::value<std::string>())
+        ("delta", "Topic endpoint sends only objects that moved more than this in m or m/s, plus keyframes", cxxopts::value<double>())
+        ("streams", "Output streams name:format:rate separated by ';', format text, binary or topics, rate in Hz or 0 for every step. "
+            "Replaces state-format and state-topics endpoints, e.g. state:text:0;ui:binary:30;log:text:1", cxxopts::value<std::string>())
         ("h,help", "Print usage");
     auto result = options.parse(argc, argv);
     if(result.count("help"))
@@ -22,23 +44,190 @@ void parseArgs(int argc, char** argv, Params& p)
         std::cout << options.help() << std::endl;
         exit(0);
     }
+    // in offline and ensemble mode stdout carries results
+    std::ostream& info = result.count("offline") || result.count("ensemble") ? std::cerr : std::cout;
     if(result.count("dt"))
     {
         p.STEP_TIME = result["dt"].as<int>()/1000.0;
-        std::cout << "Step time changed to " << p.STEP_TIME << "s" << std::endl;
+        info << "Step time changed to " << p.STEP_TIME << "s" << std::endl;
     }
     if(result.count("ode"))
     {
         p.ODE_METHOD = result["ode"].as<std::string>();
-        std::cout << "ODE method changed to " << p.ODE_METHOD  << std::endl;
+        info << "ODE method changed to " << p.ODE_METHOD  << std::endl;
+    }
+    if(result.count("state-format"))
+    {
+        p.STATE_FORMAT = result["state-format"].as<std::string>();
+        if(p.STATE_FORMAT != "text" && p.STATE_FORMAT != "binary" && p.STATE_FORMAT != "both")
+        {
+            std::cerr << "Unknown state format: " << p.STATE_FORMAT << std::endl;
+            exit(1);
+        }
+        info << "State format changed to " << p.STATE_FORMAT  << std::endl;
+    }
+    if(result.count("log-overflow"))
+    {
+        p.LOG_OVERFLOW = result["log-overflow"].as<std::string>();
+        OverflowPolicy policy;
+        if(!AsyncLogger::policyFromString(p.LOG_OVERFLOW, policy))
+        {
+            std::cerr << "Unknown log overflow policy: " << p.LOG_OVERFLOW << std::endl;
+            exit(1);
+        }
+        info << "Log overflow policy changed to " << p.LOG_OVERFLOW  << std::endl;
+    }
+    if(result.count("threads"))
+    {
+        p.THREADS = result["threads"].as<int>();
+        if(p.THREADS < 0)
+        {
+            std::cerr << "Number of threads can not be negative" << std::endl;
+            exit(1);
+        }
+        info << "Integration threads changed to " << p.THREADS << std::endl;
+    }
+    if(result.count("terrain"))
+    {
+        p.TERRAIN = result["terrain"].as<std::string>();
+        info << "Terrain: " << p.TERRAIN << std::endl;
+    }
+    if(result.count("wind-field"))
+    {
+        p.WIND_FIELD = result["wind-field"].as<std::string>();
+        info << "Wind field: " << p.WIND_FIELD << std::endl;
+    }
+    if(result.count("atmosphere"))
+    {
+        p.ATMOSPHERE = result["atmosphere"].as<std::string>();
+        info << "Atmosphere changed to " << p.ATMOSPHERE << std::endl;
+    }
+    if(result.count("shm-ring"))
+    {
+        p.SHM_RING = result["shm-ring"].as<std::string>();
+        info << "Shared memory ring: " << p.SHM_RING << std::endl;
+    }
+    if(result.count("state-topics"))
+    {
+        p.STATE_TOPICS = true;
+        info << "State topics enabled" << std::endl;
+    }
+    if(result.count("regions"))
+    {
+        p.STATE_REGIONS = result["regions"].as<std::string>();
+        std::vector<TopicPublisher::Region> regions;
+        if(!TopicPublisher::parseRegions(p.STATE_REGIONS, regions))
+        {
+            std::cerr << "Invalid regions: " << p.STATE_REGIONS << std::endl;
+            exit(1);
+        }
+        p.STATE_TOPICS = true;
+        info << "State topic regions: " << regions.size() << std::endl;
+    }
+    if(result.count("delta"))
+    {
+        p.DELTA_THRESHOLD = result["delta"].as<double>();
+        if(p.DELTA_THRESHOLD < 0.0)
+        {
+            std::cerr << "Delta threshold can not be negative" << std::endl;
+            exit(1);
+        }
+        p.STATE_TOPICS = true;
+        info << "State topic delta threshold changed to " << p.DELTA_THRESHOLD << std::endl;
+    }
+    if(result.count("streams"))
+    {
+        p.STREAMS = result["streams"].as<std::string>();
+        std::vector<OutputStreams::Stream> streams;
+        if(!OutputStreams::parse(p.STREAMS, streams) || streams.empty())
+        {
+            std::cerr << "Invalid output streams: " << p.STREAMS << std::endl;
+            exit(1);
+        }
+        info << "Output streams: " << streams.size() << std::endl;
+    }
+    if(result.count("offline"))
+    {
+        p.OFFLINE_SCENARIO = result["offline"].as<std::string>();
+        info << "Offline scenario: " << p.OFFLINE_SCENARIO << std::endl;
+    }
+    if(result.count("ensemble"))
+    {
+        p.ENSEMBLE_CONFIG = result["ensemble"].as<std::string>();
+        info << "Ensemble config: " << p.ENSEMBLE_CONFIG << std::endl;
+    }
+    if((result.count("output") || result.count("duration")) && !result.count("offline"))
+    {
+        std::cerr << "Options output and duration require offline" << std::endl;
+        exit(1);
+    }
+    if(result.count("output"))
+    {
+        p.OFFLINE_OUTPUT = result["output"].as<std::string>();
+    }
+    if(result.count("duration"))
+    {
+        p.OFFLINE_DURATION = result["duration"].as<double>();
     }
 }
 
+/// @brief Run scenario from file without sockets
+/// @param params simulation params
+/// @return exit code
+int runOffline(const Params& params)
+{
+    std::ifstream scenario(params.OFFLINE_SCENARIO);
+    if(!scenario)
+    {
+        std::cerr << "Can not open scenario: " << params.OFFLINE_SCENARIO << std::endl;
+        return 1;
+    }
+    OfflineRunner runner(params);
+    if(!runner.load(scenario)) return 1;
+    if(params.OFFLINE_OUTPUT.empty())
+    {
+        return runner.run(std::cout) ? 0 : 1;
+    }
+    std::ofstream out(params.OFFLINE_OUTPUT);
+    if(!out)
+    {
+        std::cerr << "Can not open output: " << params.OFFLINE_OUTPUT << std::endl;
+        return 1;
+    }
+    return runner.run(out) ? 0 : 1;
+}
+
+/// @brief Run Monte Carlo ensemble and print statistics
+/// @param params simulation params
+/// @return exit code
+int runEnsemble(const Params& params)
+{
+    std::ifstream file(params.ENSEMBLE_CONFIG);
+    ensemble::Config config;
+    if(!file || !config.load(file))
+    {
+        std::cerr << "Can not read ensemble config: " << params.ENSEMBLE_CONFIG << std::endl;
+        return 1;
+    }
+    ensemble::Result result;
+    if(!ensemble::run(config, params, result)) return 1;
+    result.print(std::cout);
+    return 0;
+}
+
 int main(int argc, char** argv)
 {
     Params params{};
     parseArgs(argc,argv, params);
     Logger::setLogDirectory("drop_physic");
+    if(!params.ENSEMBLE_CONFIG.empty())
+    {
+        return runEnsemble(params);
+    }
+    if(!params.OFFLINE_SCENARIO.empty())
+    {
+        return runOffline(params);
+    }
     Simulation s(params);
     s.run();
 }
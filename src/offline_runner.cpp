@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <charconv>
+#include <iostream>
+#include <sstream>
+#include "offline_runner.hpp"
+#include "command_parser.hpp"
+
+OfflineRunner::OfflineRunner(const Params& params)
+    : _params{params}, engine{params}, endTime{params.OFFLINE_DURATION}
+{
+}
+
+bool OfflineRunner::load(std::istream& scenario)
+{
+    std::string line;
+    int lineNo = 0;
+    while(std::getline(scenario, line))
+    {
+        lineNo++;
+        if(line.empty() || line[0] == '#') continue;
+        std::istringstream iss(line);
+        double time;
+        std::string msg;
+        if(!(iss >> time >> msg))
+        {
+            std::cerr << "Invalid scenario line " << lineNo << ": " << line << std::endl;
+            return false;
+        }
+        if(msg[0] == 's')
+        {
+            endTime = std::min(endTime, time);
+            continue;
+        }
+        Entry entry{time, {}};
+        cmd::Error error = cmd::parseCommand(msg, entry.commands);
+        if(error != cmd::Error::none)
+        {
+            std::cerr << "Invalid scenario command (" << cmd::errorName(error) << ") in line " << lineNo << ": " << line << std::endl;
+            return false;
+        }
+        timeline.push_back(std::move(entry));
+    }
+    std::stable_sort(timeline.begin(), timeline.end(),
+        [](const Entry& a, const Entry& b) {return a.time < b.time;});
+    return true;
+}
+
+bool OfflineRunner::run(std::ostream& out)
+{
+    if(!engine.valid())
+    {
+        std::cerr << "Failed to configure engine" << std::endl;
+        return false;
+    }
+    State& state = engine.getState();
+    const double eps = 0.5*_params.STEP_TIME;
+    std::string buffer = "time,id,PosX,PosY,PosZ,VelX,VelY,VelZ\n";
+    size_t next = 0;
+    while(state.real_time < endTime - eps)
+    {
+        for (; next < timeline.size() && timeline[next].time <= state.real_time + eps; next++)
+        {
+            for(const auto& command: timeline[next].commands)
+            {
+                engine.apply(command);
+            }
+        }
+        engine.step();
+        writeState(buffer);
+        if(buffer.size() > (1 << 16))
+        {
+            out.write(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    }
+    out.write(buffer.data(), buffer.size());
+    out.flush();
+    return true;
+}
+
+void OfflineRunner::writeState(std::string& buffer)
+{
+    State& state = engine.getState();
+    char line[256];
+    for (int i = 0; i < state.getNoSlots(); i++)
+    {
+        const ObjParams* p = state.getParams(i);
+        if(p == nullptr) continue;
+        char* ptr = std::to_chars(line, line + sizeof(line), state.real_time).ptr;
+        *ptr++ = ',';
+        ptr = std::to_chars(ptr, line + sizeof(line), p->id).ptr;
+        const Eigen::Vector3d pos = state.getPos(i);
+        const Eigen::Vector3d vel = state.getVel(i);
+        for(double value: {pos.x(), pos.y(), pos.z(), vel.x(), vel.y(), vel.z()})
+        {
+            *ptr++ = ',';
+            ptr = std::to_chars(ptr, line + sizeof(line), value).ptr;
+        }
+        *ptr++ = '\n';
+        buffer.append(line, ptr);
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include "engine.hpp"
+#include "command.hpp"
+#include "params.hpp"
+
+/// @brief Runs simulation as fast as possible, without sockets and wall clock pacing.
+/// Commands are read from scenario, trajectories are written as CSV.
+///
+/// Scenario is a text file with one command per line: time in s, space and control message
+/// in the same format as on control socket, e.g. "0.5 a:1.0,0.01,0.0,0.0,-100.0".
+/// Empty lines and lines starting with '#' are ignored. "s:" ends simulation at given time,
+/// otherwise it ends after Params::OFFLINE_DURATION.
+class OfflineRunner
+{
+    public:
+        /// @brief Constructor
+        /// @param params simulation params
+        OfflineRunner(const Params& params);
+
+        /// @brief Read scenario
+        /// @param scenario input stream with scenario
+        /// @return false if scenario has invalid line
+        bool load(std::istream& scenario);
+
+        /// @brief Run whole scenario
+        /// @param out output stream, gets CSV header and state of every object after every step
+        /// @return false if engine is not valid
+        bool run(std::ostream& out);
+
+        /// @brief Get engine, e.g. to inspect final state
+        /// @return reference to engine
+        inline Engine& getEngine() {return engine;}
+
+    private:
+        struct Entry
+        {
+            double time;
+            std::vector<cmd::Command> commands;
+        };
+
+        const Params& _params;
+        Engine engine;
+        std::vector<Entry> timeline;
+        double endTime;
+
+        void writeState(std::string& buffer);
+};
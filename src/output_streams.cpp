@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <sstream>
+#include "output_streams.hpp"
+
+OutputStreams::OutputStreams(const Params& params)
+{
+    std::string spec = params.STREAMS;
+    if(spec.empty())
+    {
+        if(params.STATE_FORMAT != "binary") spec += "state:text:0;";
+        if(params.STATE_FORMAT != "text") spec += "state_bin:binary:0;";
+        if(params.STATE_TOPICS) spec += "state_topics:topics:0;";
+    }
+    _valid = parse(spec, streams);
+    for(auto& stream: streams)
+    {
+        if(stream.rate > 0.0)
+        {
+            stream.interval = std::max<uint64_t>(1, std::llround(1.0/(stream.rate*params.STEP_TIME)));
+        }
+        if(stream.format != Format::topics) continue;
+        stream.topics = std::make_unique<TopicPublisher>(params.STATE_REGIONS, params.DELTA_THRESHOLD, stream.interval > 1);
+        _valid = _valid && stream.topics->valid();
+    }
+}
+
+bool OutputStreams::parse(const std::string& spec, std::vector<Stream>& streams)
+{
+    std::istringstream items(spec);
+    std::string item;
+    while(std::getline(items, item, ';'))
+    {
+        if(item.empty()) continue;
+        std::istringstream fields(item);
+        std::string name, format, rate;
+        if(!std::getline(fields, name, ':') || !std::getline(fields, format, ':') || !std::getline(fields, rate)
+            || name.empty() || name.find('/') != std::string::npos || name == "control" || name == "stats")
+        {
+            return false;
+        }
+        Stream stream;
+        stream.name = name;
+        if(format == "text") stream.format = Format::text;
+        else if(format == "binary") stream.format = Format::binary;
+        else if(format == "topics") stream.format = Format::topics;
+        else return false;
+        auto [end, ec] = std::from_chars(rate.data(), rate.data() + rate.size(), stream.rate);
+        if(ec != std::errc() || end != rate.data() + rate.size() || !std::isfinite(stream.rate) || stream.rate < 0.0)
+        {
+            return false;
+        }
+        for(const auto& other: streams)
+        {
+            if(other.name == name) return false;
+        }
+        streams.push_back(std::move(stream));
+    }
+    return true;
+}
+
+int OutputStreams::update(State& state)
+{
+    bool textNeeded[2] = {false, false}, frameNeeded[2] = {false, false};
+    int due = 0;
+    for(auto& stream: streams)
+    {
+        stream.due = state.tick >= stream.next;
+        if(!stream.due) continue;
+        due++;
+        stream.next = state.tick + stream.interval;
+        const int all = stream.interval > 1 ? 1 : 0;
+        switch(stream.format)
+        {
+            case Format::text:
+                textNeeded[all] = true;
+                break;
+            case Format::binary:
+                frameNeeded[all] = true;
+                break;
+            case Format::topics:
+                stream.topics->update(state);
+                break;
+        }
+    }
+    for (int all = 0; all < 2; all++)
+    {
+        if(textNeeded[all]) texts[all] = state.to_string(all);
+        if(frameNeeded[all]) state.to_frame(frames[all], all);
+    }
+    return due;
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "state.hpp"
+#include "params.hpp"
+#include "topic_publisher.hpp"
+
+/// @brief State output streams with own rate and format, independent of physics step.
+/// Streams are described as "name:format:rate" separated by ';', e.g. "state:text:0;ui:text:30;log:binary:1".
+/// Format is text (State::to_string), binary (state_frame.hpp) or topics (TopicPublisher).
+/// Rate is in Hz, 0 publishes every step. Rate is converted once to interval in whole steps, rounded to nearest,
+/// and streams are scheduled on State::tick, so publications are exactly interval apart without jitter.
+/// E.g. 30 Hz with 3 ms step is published every 11 steps. Streams slower than every step include
+/// sleeping objects every time, because sparse publication of sleeping objects is tied to step count.
+/// State is serialized once per step for every format and object set needed by due streams
+class OutputStreams
+{
+    public:
+        enum class Format {text, binary, topics};
+
+        /// @brief Single output stream
+        struct Stream
+        {
+            /// @brief endpoint name
+            std::string name;
+            Format format;
+            /// @brief rate in Hz, 0 for every step
+            double rate;
+            /// @brief number of steps between publications, at least 1
+            uint64_t interval = 1;
+            /// @brief tick of next publication
+            uint64_t next = 0;
+            /// @brief true if stream is published in current step
+            bool due = false;
+            /// @brief topic builder of topics stream, it keeps own delta state
+            std::unique_ptr<TopicPublisher> topics;
+        };
+
+        /// @brief Constructor. Uses Params::STREAMS, or streams given by Params::STATE_FORMAT
+        /// and Params::STATE_TOPICS if it is empty
+        /// @param params simulation params
+        OutputStreams(const Params& params);
+
+        /// @brief Check if stream description is valid
+        /// @return false if streams or regions can not be parsed
+        inline bool valid() const {return _valid;}
+
+        /// @brief Parse streams description
+        /// @param spec streams description
+        /// @param streams output
+        /// @return false if spec is invalid, names repeat or clash with control and stats endpoints
+        static bool parse(const std::string& spec, std::vector<Stream>& streams);
+
+        /// @brief Get number of streams
+        inline size_t size() const {return streams.size();}
+
+        /// @brief Get stream
+        /// @param i stream index
+        inline const Stream& at(size_t i) const {return streams[i];}
+
+        /// @brief Find streams due at current tick and serialize state for them
+        /// @param state simulation state
+        /// @return number of due streams
+        int update(State& state);
+
+        /// @brief Get text state serialized by last update for stream
+        /// @param i index of due text stream
+        inline const std::string& text(size_t i) const {return texts[everyObject(i)];}
+
+        /// @brief Get binary frame serialized by last update for stream
+        /// @param i index of due binary stream
+        inline const std::vector<char>& frame(size_t i) const {return frames[everyObject(i)];}
+
+        /// @brief Get topic messages built by last update for stream
+        /// @param i index of due topics stream
+        inline const TopicPublisher& topics(size_t i) const {return *streams[i].topics;}
+
+    private:
+        std::vector<Stream> streams;
+        bool _valid;
+        std::string texts[2];
+        std::vector<char> frames[2];
+
+        inline int everyObject(size_t i) const {return streams[i].interval > 1 ? 1 : 0;}
+};
@@ -14,6 +14,21 @@ Params::Params()
 
     STEP_TIME = 0.003;
     ODE_METHOD = "RK4";
+    STATE_FORMAT = "text";
+    LOG_OVERFLOW = "drop";
+    OFFLINE_SCENARIO = "";
+    OFFLINE_OUTPUT = "";
+    OFFLINE_DURATION = 60.0;
+    ENSEMBLE_CONFIG = "";
+    THREADS = 0;
+    TERRAIN = "";
+    WIND_FIELD = "";
+    ATMOSPHERE = "constant";
+    SHM_RING = "";
+    STATE_TOPICS = false;
+    STATE_REGIONS = "";
+    DELTA_THRESHOLD = 0.0;
+    STREAMS = "";
 }
 
 Params::~Params() 
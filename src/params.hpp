@@ -21,6 +21,52 @@ public:
     /// @brief ODE solving method used in simulation
     std::string ODE_METHOD;
 
+    /// @brief Format of published state: "text", "binary" or "both"
+    std::string STATE_FORMAT;
+
+    /// @brief Trajectory log behaviour when writer can not keep up: "drop", "block" or "decimate"
+    std::string LOG_OVERFLOW;
+
+    /// @brief Path of scenario file. If not empty, simulation runs offline, faster than real time
+    std::string OFFLINE_SCENARIO;
+
+    /// @brief Path of trajectory output in offline mode. Empty means stdout
+    std::string OFFLINE_OUTPUT;
+
+    /// @brief Maximal simulated time in offline mode in s
+    double OFFLINE_DURATION;
+
+    /// @brief Path of Monte Carlo ensemble config. If not empty, ensemble is run instead of simulation
+    std::string ENSEMBLE_CONFIG;
+
+    /// @brief Number of threads integrating objects. 0 means hardware concurrency
+    int THREADS;
+
+    /// @brief Path of terrain index file. If not empty, ground collisions are detected by engine
+    std::string TERRAIN;
+
+    /// @brief Path of gridded wind field file. If not empty, objects without own wind are blown by this field
+    std::string WIND_FIELD;
+
+    /// @brief Atmosphere model used for drag: "constant" or "ISA"
+    std::string ATMOSPHERE;
+
+    /// @brief Name of shared memory state ring, e.g. "/drop_shot_state". If empty, ring is not created
+    std::string SHM_RING;
+
+    /// @brief Publish state split by ZMQ topics on state_topics endpoint
+    bool STATE_TOPICS;
+
+    /// @brief Regions of interest of topic endpoint, "name,xmin,ymin,zmin,xmax,ymax,zmax" separated by ';'
+    std::string STATE_REGIONS;
+
+    /// @brief Topic endpoint sends only objects that moved more than this in m or m/s, plus keyframes. 0 sends all
+    double DELTA_THRESHOLD;
+
+    /// @brief Output streams "name:format:rate" separated by ';', format is text, binary or topics and rate in Hz,
+    /// 0 for every step. If empty, streams are given by STATE_FORMAT and STATE_TOPICS
+    std::string STREAMS;
+
     /// @brief Get singleton of Params.
     /// @return const pointer to Params instance. Return nullptr if not initialized
     static const Params* getSingleton();
@@ -0,0 +1,87 @@
+#include <atomic>
+#include <iostream>
+#include <new>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "shm_publisher.hpp"
+
+ShmPublisher::~ShmPublisher()
+{
+    destroy();
+}
+
+void ShmPublisher::destroy()
+{
+    if(mapping == nullptr) return;
+    munmap(mapping, bytes);
+    shm_unlink(_name.c_str());
+    mapping = nullptr;
+    header = nullptr;
+    bytes = 0;
+}
+
+bool ShmPublisher::create(const std::string& name, int slots, int maxObjects)
+{
+    destroy();
+    const size_t slotSize = drop_ring::slotSize(maxObjects);
+    if(slots < 1 || maxObjects < 0 || slotSize > UINT32_MAX)
+    {
+        std::cerr << "Invalid shared memory ring size" << std::endl;
+        return false;
+    }
+    // readers of old ring keep their mapping, new ones open the new ring
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if(fd < 0)
+    {
+        std::cerr << "Can not create shared memory ring: " << name << std::endl;
+        return false;
+    }
+    const size_t size = drop_ring::ringSize(slots, slotSize);
+    void* data = MAP_FAILED;
+    if(ftruncate(fd, size) == 0)
+    {
+        data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if(data == MAP_FAILED)
+    {
+        std::cerr << "Can not map shared memory ring: " << name << std::endl;
+        shm_unlink(name.c_str());
+        return false;
+    }
+    _name = name;
+    mapping = data;
+    bytes = size;
+    written = 0;
+    // memory is zeroed by ftruncate, so all slot sequences are 0
+    header = new (mapping) drop_ring::Header{drop_ring::MAGIC, drop_ring::VERSION, sizeof(drop_ring::Header),
+        static_cast<uint32_t>(slots), static_cast<uint32_t>(slotSize), {0}, {0}};
+    return true;
+}
+
+bool ShmPublisher::publish(State& state)
+{
+    const uint64_t n = written + 1;
+    char* base = static_cast<char*>(mapping) + header->headerSize;
+    auto* slot = reinterpret_cast<drop_ring::Slot*>(base + (n % header->slots)*header->slotSize);
+    slot->seq.store(2*n - 1, std::memory_order_relaxed);
+    // readers that see new data also see odd sequence
+    std::atomic_thread_fence(std::memory_order_release);
+    const size_t size = state.to_frame(reinterpret_cast<char*>(slot + 1), header->slotSize - sizeof(drop_ring::Slot));
+    if(size == 0)
+    {
+        // slot keeps odd sequence, readers see overwritten frame, which is true
+        header->oversized.fetch_add(1, std::memory_order_relaxed);
+        if(!warned) std::cerr << "State frame does not fit into shared memory ring slot" << std::endl;
+        warned = true;
+        return false;
+    }
+    slot->size = size;
+    slot->seq.store(2*n, std::memory_order_release);
+    header->written.store(n, std::memory_order_release);
+    written = n;
+    return true;
+}
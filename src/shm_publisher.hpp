@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "state.hpp"
+#include "state_ring.hpp"
+
+/// @brief Writer of shared memory ring of state frames described in state_ring.hpp.
+/// Single producer: only simulation thread publishes. Readers use drop_ring::Reader
+class ShmPublisher
+{
+    public:
+        /// @brief Constructor. Nothing is published until ring is created
+        ShmPublisher() = default;
+
+        ShmPublisher(const ShmPublisher&) = delete; // no copies
+        ShmPublisher& operator=(const ShmPublisher&) = delete; // no self-assignments
+
+        /// @brief Deconstructor. Unmaps and removes ring
+        ~ShmPublisher();
+
+        /// @brief Create ring, existing ring of the same name is replaced
+        /// @param name shared memory object name, e.g. "/drop_shot_state"
+        /// @param slots number of frames kept in ring
+        /// @param maxObjects largest number of objects in frame
+        /// @return false if shared memory can not be created
+        bool create(const std::string& name, int slots, int maxObjects);
+
+        /// @brief Check if ring was created
+        inline bool ready() const {return header != nullptr;}
+
+        /// @brief Write current state as next frame. Frames larger than slot are counted and dropped
+        /// @param state simulation state
+        /// @return false if frame did not fit into slot
+        bool publish(State& state);
+
+        /// @brief Get number of published frames
+        inline uint64_t published() const {return written;}
+
+    private:
+        std::string _name;
+        void* mapping = nullptr;
+        size_t bytes = 0;
+        drop_ring::Header* header = nullptr;
+        uint64_t written = 0;
+        bool warned = false;
+
+        void destroy();
+};
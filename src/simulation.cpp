@@ -3,37 +3,60 @@
 #include <iostream>
 #include <cstdio>
 #include <thread>
-#include <mutex>
 #include <Eigen/Dense>
 #include <functional>
-#include <map>
 #include <filesystem>
+#include <sstream>
+#include <variant>
 namespace fs = std::filesystem;
 #include "simulation.hpp"
 #include "common.hpp"
 #include "state.hpp"
+#include "command_parser.hpp"
 
 
 Simulation::Simulation(const Params& params)
-    : _params{params}, ode{ODE::factory(ODE::fromString(params.ODE_METHOD))}
+    : _params{params}, engine{params}, state{engine.getState()}, predictor{params.STEP_TIME,params.ODE_METHOD,engine.getAtmosphere(),engine.getWindField()}, stats{params.STEP_TIME},
+    streams{params}
 {
-    if(ode == nullptr)
+    if(!engine.valid())
     {
-        std::cerr << "Failed to get ODE algorithm" << std::endl;
+        std::cerr << "Failed to configure engine" << std::endl;
         return;
     }
+    if(!streams.valid())
+    {
+        std::cerr << "Failed to configure output streams" << std::endl;
+        return;
+    }
+    stats.attachLogger(state.getLogger());
+    touched.reserve(def::CONTROL_BATCH_RESERVE);
     if (!std::filesystem::exists(path.substr(6)) && !fs::create_directory(path.substr(6)))
         std::cerr <<  "Can not create comunication folder" <<std::endl;
-    calcRHS();
-    statePublishSocket = zmq::socket_t(_ctx, zmq::socket_type::pub);
-    statePublishSocket.bind(path + "/state");
-    std::cout << "Drop&shot state: " << path + "/state" << std::endl;
+    for (size_t i = 0; i < streams.size(); i++)
+    {
+        const std::string endpoint = path + "/" + streams.at(i).name;
+        streamSockets.emplace_back(_ctx, zmq::socket_type::pub);
+        streamSockets.back().bind(endpoint);
+        std::cout << "Drop&shot " << streams.at(i).name << " stream: " << endpoint << std::endl;
+    }
+    if(!_params.SHM_RING.empty() && ring.create(_params.SHM_RING, def::SHM_RING_SLOTS, def::SHM_RING_MAX_OBJECTS))
+    {
+        std::cout << "Drop&shot shared memory state: " << _params.SHM_RING << std::endl;
+    }
+    statsSocket = zmq::socket_t(_ctx, zmq::socket_type::pub);
+    statsSocket.bind(path + "/stats");
+    std::cout << "Drop&shot tick stats: " << path + "/stats" << std::endl;
     controlListener = std::thread([this]()
     {
         std::cout << "Drop&shot control: " << path + "/control"  << std::endl;
         zmq::socket_t controlInSock = zmq::socket_t(_ctx, zmq::socket_type::rep);
         controlInSock.bind(path + "/control");
         bool run = true;
+        // parsed commands are copied into spare node of queue, so buffer keeps its capacity between messages.
+        // Replies longer than small string buffer and ZMQ messages still allocate
+        std::vector<cmd::Command> batch;
+        batch.reserve(def::CONTROL_BATCH_RESERVE);
         while(run)
         {
             zmq::message_t msg;
@@ -43,25 +66,37 @@ Simulation::Simulation(const Params& params)
                 std::cerr << "Listener recv error" << std::endl;
                 return;
             } 
-            std::string msg_str =  std::string(static_cast<char*>(msg.data()), msg.size());
+            const std::string_view msg_str(static_cast<char*>(msg.data()), msg.size());
             zmq::message_t response("ok",2);
-            switch(msg_str[0])
+            switch(msg_str.empty() ? '\0' : msg_str[0])
             {
                 case 'a':
-                    addCommand(msg_str,controlInSock);
-                break;
                 case 'r':
-                    removeObj(std::stoi(msg_str.substr(2)));
-                    controlInSock.send(response,zmq::send_flags::none);
-                break;
                 case 'w':
-                    updateWind(msg_str,controlInSock);
-                break;
                 case 'f':
-                    updateForce(msg_str,controlInSock);
-                break;
                 case 'j':
-                    solidSurfColision(msg_str,controlInSock);
+                case 'b':
+                {
+                    batch.clear();
+                    std::string reply = msg_str[0] == 'b' ? cmd::parseBatch(msg_str,batch) : cmd::parse(msg_str,batch);
+                    commands.push(batch);
+                    response.rebuild(reply.data(),reply.size());
+                    controlInSock.send(response,zmq::send_flags::none);
+                }
+                break;
+                case 'p':
+                {
+                    std::string reply = impactQuery(msg_str);
+                    response.rebuild(reply.data(),reply.size());
+                    controlInSock.send(response,zmq::send_flags::none);
+                }
+                break;
+                case 't':
+                {
+                    std::string reply = stats.report();
+                    response.rebuild(reply.data(),reply.size());
+                    controlInSock.send(response,zmq::send_flags::none);
+                }
                 break;
                 case 's':
                     run = false;
@@ -83,19 +118,47 @@ Simulation::Simulation(const Params& params)
 
 void Simulation::run()
 {
-    if(ode == nullptr)
+    if(!engine.valid() || !streams.valid())
     {
         std::cerr << "Exitting!" << std::endl;
         return;
     }
     TimedLoop loop(std::round(_params.STEP_TIME*1000.0), [this](){
-        std::unique_lock<std::mutex> lock(state.stateMutex);
-        Eigen::VectorXd next = ode->step(state.real_time,state.getState(),RHS,_params.STEP_TIME);
-        state.updateState(next);
-        state.real_time += _params.STEP_TIME;
-        auto msg = state.to_string();
-        lock.unlock();
-        sendState(std::move(msg));
+        stats.begin();
+        touched.clear();
+        int applied = commands.drain([this](const cmd::Command& command)
+        {
+            engine.apply(command);
+            // new objects have no prediction and wind changes are detected by predictor itself
+            if(const auto* remove = std::get_if<cmd::Remove>(&command))
+            {
+                predictor.forget(remove->id);
+            }
+            else if(const auto* force = std::get_if<cmd::Force>(&command))
+            {
+                touched.push_back(force->id);
+            }
+            else if(const auto* collision = std::get_if<cmd::Collision>(&command))
+            {
+                touched.push_back(collision->id);
+            }
+        });
+        stats.lap(TickStats::commands);
+        engine.step();
+        touched.insert(touched.end(), engine.getDisturbed().begin(), engine.getDisturbed().end());
+        if(!touched.empty()) predictor.invalidate(touched);
+        stats.lap(TickStats::integration);
+        state.logState();
+        stats.lap(TickStats::logging);
+        streams.update(state);
+        stats.lap(TickStats::serialization);
+        sendStreams();
+        if(ring.ready()) ring.publish(state);
+        stats.lap(TickStats::publishing);
+        predictor.update(state);
+        stats.lap(TickStats::prediction);
+        stats.end(applied);
+        if(state.tick % def::STATS_PUBLISH_INTERVAL == 0) sendStats();
     }, state.status);
 
     loop.go();
@@ -104,261 +167,83 @@ void Simulation::run()
 int Simulation::addObj(double mass, double CS,
     Eigen::Vector3d pos, Eigen::Vector3d vel) 
 {
-    const std::scoped_lock lock(state.stateMutex);
-    int id = state.addObj(mass,CS,pos,vel);
-    calcRHS();
+    int id = ObjParams::nextId();
+    commands.push(cmd::Add{id,mass,CS,pos,vel});
     return id;
 }
 
 void Simulation::removeObj(int id)
 {
-    const std::scoped_lock lock(state.stateMutex);
-    state.removeObj(id);
-    calcRHS();
-}
-
-void Simulation::addCommand(std::string msg, zmq::socket_t& sock) 
-{
-    std::istringstream f(msg.substr(2));
-    std::string res;
-    int i;
-    double m = 0, CS = 0;
-    Eigen::Vector3d pos,vel;
-    for (i = 0; i < 8; i++)
-    {
-        if(!getline(f, res, ',')) break;
-        switch (i)
-        {
-            case 0:
-                m = std::stod(res);
-                break;
-            case 1:
-                CS = std::stod(res);
-                break;
-            case 2:
-            case 3:
-            case 4:
-                pos(i-2) = std::stod(res);
-                break;
-            case 5:
-            case 6:
-            case 7:
-                vel(i-5) = std::stod(res);
-                break;
-        }
-    }
-    zmq::message_t response("error",5);
-    if(i == 5 || i == 8)
-    {
-        int id = addObj(m,CS,pos,vel);
-        auto msg = "ok;" + std::to_string(id);
-        response.rebuild(msg.data(),msg.size());
-    }
-    else
-    {
-        std::cerr << "Invalid add command: " << msg << std::endl;
-    }
-    sock.send(response,zmq::send_flags::none);
-}
-
-void Simulation::updateWind(std::string msg, zmq::socket_t& sock)
-{
-    zmq::message_t response("error",5);
-    std::istringstream f(msg.substr(2));
-    std::string s, res;
-    int i;
-    std::map<int,Eigen::Vector3d> wind;
-    for (i = 0; i < state.getNoObj() + 3; i++)
-    {
-        if(!getline(f, res, ';')) break;
-        std::istringstream iss(res);
-        int id, j;
-        Eigen::Vector3d wind_vec;
-        for(j = 0; j < 4; j++)
-        {
-            if(!getline(iss, s, ',')) break;
-            switch (j)
-            {
-                case 0:
-                    id = std::stoi(s);
-                    break;
-                case 1:
-                case 2:
-                case 3:
-                    wind_vec(j-1) = std::stod(s);
-                    break;
-            }
-        }
-        if(j != 4)
-        {
-            std::cerr << "Invalid add command: " << msg << std::endl;
-            sock.send(response,zmq::send_flags::none);
-            return;
-        }
-        wind.insert({id,wind_vec});
-    }
-    for(auto &i: wind)
-    {
-        state.updateWind(i.first,i.second);
-    }
-    response.rebuild("ok",2);
-    sock.send(response,zmq::send_flags::none);
-}
-
-void Simulation::updateForce(std::string msg, zmq::socket_t &sock)
-{
-    zmq::message_t response("error",5);
-    std::istringstream f(msg.substr(2));
-    std::string s;
-    int id = -1,j;
-    Eigen::Vector3d force;
-    for(j = 0; j < 4; j++)
-    {
-        if(!getline(f, s, ',')) break;
-        switch (j)
-        {
-            case 0:
-                id = std::stoi(s);
-                break;
-            case 1:
-            case 2:
-            case 3:
-                force(j-1) = std::stod(s);
-                break;
-        }
-    }
-    if(j != 4 || id < 0)
-    {
-        std::cerr << "Invalid add command: " << msg << std::endl;
-        sock.send(response,zmq::send_flags::none);
-        return;
-    }
-    state.updateForce(id,force);
-    response.rebuild("ok",2);
-    sock.send(response,zmq::send_flags::none);
+    commands.push(cmd::Remove{id});
 }
 
-Eigen::Vector3d Simulation::calcAerodynamicForce(Eigen::Vector3d vel, ObjParams* params)
+void Simulation::calcImpulseForce(int id,double COR, double mi_static, double mi_dynamic, Eigen::Vector3d surfaceNormal)
 {
-    Eigen::Vector3d diff = vel-params->getWind();
-    double dynamic_pressure = 0.5*def::DEFAULT_AIR_DENSITY*diff.dot(diff);
-    if(dynamic_pressure == 0.0)
-    {
-        return Eigen::Vector3d(0.0,0.0,0.0);
-    }
-    return -params->CS_coff*dynamic_pressure*diff.normalized();
+    commands.push(cmd::Collision{id,COR,mi_static,mi_dynamic,surfaceNormal});
 }
 
-void Simulation::calcImpulseForce(int id,double COR, double mi_static, double mi_dynamic, Eigen::Vector3d surfaceNormal)
+std::string Simulation::impactQuery(std::string_view msg)
 {
-    const std::lock_guard<std::mutex> lock(state.stateMutex);
-    int index = state.findIndex(id);
-    if(index < 0) return;
-
-    Eigen::Vector3d v = state.getVel(index);
-    Eigen::Vector3d X_g = v;
-    double vn = v.dot(surfaceNormal);
-    if(vn >= 0.0)
-    {
-        return;
+    int id;
+    double groundZ;
+    ImpactPredictor::Prediction prediction;
+    if(!cmd::parseImpactQuery(msg, id, groundZ)
+        || !predictor.query(id, groundZ, prediction)
+        || !prediction.hit)
+    {
+        return "error";
     }
-    double mass = state.getParams(index)->mass;
-    std::cout << "Energy before collision: " << 0.5*state.getParams(index)->mass* X_g.squaredNorm() << std::endl;
-    if(vn > -def::GENTLY_PUSH) vn = -def::GENTLY_PUSH;
-    double jr = (-(1+COR)*vn)*mass;
-    X_g = X_g + (jr/mass)*surfaceNormal;
-    Eigen::Vector3d vt = v - (v.dot(surfaceNormal))*surfaceNormal;
-    if(vt.squaredNorm() > def::FRICTION_EPS)
+    std::ostringstream reply;
+    reply.precision(10);
+    reply << "ok;" << prediction.time;
+    for(double value: {prediction.pos.x(), prediction.pos.y(), prediction.pos.z(),
+        prediction.vel.x(), prediction.vel.y(), prediction.vel.z()})
     {
-        Eigen::Vector3d tangent = vt.normalized();
-        double js = mi_static*jr;
-        double jd = mi_dynamic*jr;
-        double jf = vt.norm() * mass;
-        if(jf > js) jf = jd;
-        X_g = X_g - (jf/mass) * tangent;
+        reply << ',' << value;
     }
-    std::cout << "Energy after collision: " << 0.5*state.getParams(index)->mass* v.squaredNorm()  << std::endl;
-    state.setVel(index,X_g);
-}
-
-bool isNormal(double factor)
-{
-    return factor >= 0.0 && factor <= 1.0;
+    return reply.str();
 }
 
-void Simulation::solidSurfColision(std::string& msg_str, zmq::socket_t& sock)
+void Simulation::sendStreams()
 {
-    std::istringstream f(msg_str.substr(2));
-    zmq::message_t response("error",5);
-    int i, id = -1;
-    double COR = 0.0, mi_static = 0.0, mi_dynamic = 0.0;
-    Eigen::Vector3d surfaceNormal(0.0,0.0,0.0);
-    std::string res;
-    for (i = 0; i < 7; i++)
+    for (size_t i = 0; i < streams.size(); i++)
     {
-        if(!getline(f, res, ',')) break;
-        switch (i)
+        if(!streams.at(i).due) continue;
+        zmq::socket_t& socket = streamSockets[i];
+        switch(streams.at(i).format)
         {
-        case 0:
-            id = std::stoi(res);
-        break;
-        case 1:
-            COR = std::stod(res);
-            break;
-        case 2:
-            mi_static = std::stod(res);
+            case OutputStreams::Format::text:
+            {
+                const std::string& text = streams.text(i);
+                socket.send(zmq::buffer(text.data(), text.size()),zmq::send_flags::none);
+            }
             break;
-        case 3:
-            mi_dynamic = std::stod(res);
+            case OutputStreams::Format::binary:
+            {
+                const std::vector<char>& frame = streams.frame(i);
+                socket.send(zmq::buffer(frame.data(), frame.size()),zmq::send_flags::none);
+            }
             break;
-        case 4:
-        case 5:
-        case 6:
-            surfaceNormal(i-4) = std::stod(res);
+            case OutputStreams::Format::topics:
+            {
+                const TopicPublisher& topics = streams.topics(i);
+                for (size_t m = 0; m < topics.size(); m++)
+                {
+                    const TopicPublisher::Message& message = topics.at(m);
+                    socket.send(zmq::buffer(message.topic.data(), message.topic.size()),zmq::send_flags::sndmore);
+                    socket.send(zmq::buffer(message.payload.data(), message.payload.size()),zmq::send_flags::none);
+                }
+            }
             break;
         }
     }
-    if (i == 7
-        && id >= 0
-        && isNormal(COR)
-        && isNormal(mi_static)
-        && isNormal(mi_dynamic)
-        && mi_static >= mi_dynamic)
-    {
-        calcImpulseForce(id,COR, mi_static, mi_dynamic, surfaceNormal);
-        response.rebuild("ok",2);
-    }
-    sock.send(response,zmq::send_flags::none);
-    return; 
-}
-
-void Simulation::calcRHS()
-{
-    static const Eigen::Vector3d gravity = Eigen::Vector3d(0.0,0.0,def::GRAVITY_CONST);
-    if(state.getNoObj() == 0)
-    {
-        RHS = [] (double, Eigen::VectorXd) {return Eigen::VectorXd();};
-        return;
-    }
-    RHS = [this] (double, Eigen::VectorXd local_state) 
-        {
-            int no = state.getNoObj();
-            Eigen::VectorXd res(6*no);
-            res.segment(0,6*no - 3) = local_state.segment(3, 6*no-3);
-            for (int i = 0; i < no; i++)
-            {
-                ObjParams* p = state.getParams(i);
-                Eigen::Vector3d vel = local_state.segment<3>(3+6*i);
-                res.segment<3>(3+6*i) = (p->mass*gravity + calcAerodynamicForce(vel,p) + p->getForce())/p->mass;
-            }
-            return res;
-        };
 }
 
-void Simulation::sendState(std::string&& msg)
+void Simulation::sendStats()
 {
-    zmq::message_t message(msg.data(), msg.size());
-    statePublishSocket.send(message,zmq::send_flags::none);
+    std::string report = stats.report();
+    zmq::message_t message(report.data(), report.size());
+    statsSocket.send(message,zmq::send_flags::none);
 }
 
 Simulation::~Simulation()
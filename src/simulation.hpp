@@ -1,12 +1,20 @@
 #pragma once
 #include <zmq.hpp>
+#include <string_view>
 #include <thread>
+#include <vector>
 #include "state.hpp"
+#include "engine.hpp"
 #include <Eigen/Dense>
 #include <functional>
 #include "common.hpp"
 #include "defines.hpp"
 #include "params.hpp"
+#include "command_queue.hpp"
+#include "impact_predictor.hpp"
+#include "tick_stats.hpp"
+#include "shm_publisher.hpp"
+#include "output_streams.hpp"
 
 
 
@@ -22,40 +30,22 @@ class Simulation
         /// @brief Run simulation
         void run();
 
-        /// @brief Add new object to simulation
+        /// @brief Add new object to simulation. Object is created at the beginning of next step.
+        /// Thread safe
         /// @param mass obj mass
         /// @param CS aerodynamic drag force cofficent multipled by aerodynamic field
         /// @param pos start position of object
         /// @param vel start velocity of object
         /// @return id of added object
         int addObj(double mass, double CS,
-            Eigen::Vector3d pos, Eigen::Vector3d vel = Eigen::Vector3d());
+            Eigen::Vector3d pos, Eigen::Vector3d vel = Eigen::Vector3d::Zero());
             
-        /// @brief Remove object from simulation
+        /// @brief Remove object from simulation at the beginning of next step. Thread safe
         /// @param id object id
         void removeObj(int id);
 
-        /// @brief Handle add new object command
-        /// @param msg message content
-        /// @param sock zmq socket reply is send by
-        void addCommand(std::string msg, zmq::socket_t& sock);
-
-        /// @brief Handle update wind command
-        /// @param msg message content
-        /// @param sock zmq socket reply is send by
-        void updateWind(std::string msg, zmq::socket_t& sock);
-
-        /// @brief Handle update force command
-        /// @param msg message content
-        /// @param sock zmq socket reply is send by
-        void updateForce(std::string msg, zmq::socket_t& sock);
-
-        /// @brief Handle solid surface collision command
-        /// @param msg message content
-        /// @param sock zmq socket reply is send by
-        void solidSurfColision(std::string& msg_str, zmq::socket_t& sock);
-
-        /// @brief Calculates object state after collision with given surface
+        /// @brief Calculates object state after collision with given surface at the beginning of next step.
+        /// Thread safe
         /// @param id object id
         /// @param COR coefficient of restitution. e = 0 is perfect inelastic collision, e = 1 is perfect elastic collision.
         /// 0 < e < 1 is a real-world inelastic collision, in which some kinetic energy is dissipated.
@@ -69,14 +59,21 @@ class Simulation
         const std::string path = "ipc:///tmp/drop_shot";
 
         zmq::context_t _ctx;
-        State state;
-        std::function<Eigen::VectorXd(double,Eigen::VectorXd)> RHS;
-        std::thread controlListener;
-        zmq::socket_t statePublishSocket;
         const Params& _params;
-        std::unique_ptr<ODE> ode;
+        Engine engine;
+        State& state;
+        CommandQueue commands;
+        ImpactPredictor predictor;
+        /// @brief ids of objects whose predictions are invalidated in current step, buffer reused between steps
+        std::vector<int> touched;
+        TickStats stats;
+        std::thread controlListener;
+        zmq::socket_t statsSocket;
+        OutputStreams streams;
+        std::vector<zmq::socket_t> streamSockets;
+        ShmPublisher ring;
 
-        void sendState(std::string&& msg);
-        void calcRHS();
-        Eigen::Vector3d calcAerodynamicForce(Eigen::Vector3d vel, ObjParams* params);
+        std::string impactQuery(std::string_view msg);
+        void sendStreams();
+        void sendStats();
 };
@@ -1,38 +1,24 @@
 #include <Eigen/Dense>
-#include <mutex>
 #include <iostream>
+#include <algorithm>
+#include <cstring>
 #include "state.hpp"
 #include "common.hpp"
 #include "params.hpp"
 #include "defines.hpp"
+#include "state_frame.hpp"
 
-int ObjParams::counter = 0;
+std::atomic_int ObjParams::counter = 0;
 
 
-void ObjParams::setWind(Eigen::Vector3d newWind) 
-{
-    std::scoped_lock lock(mtxWind);
-    wind = newWind;
-}
-
-Eigen::Vector3d ObjParams::getWind()
-{
-    std::scoped_lock lock(mtxWind);
-    return wind;
-}
-
 void ObjParams::setForce(Eigen::Vector3d newForce)
 {
-  static const int ODE_microsteps =
-      ODE::getMicrosteps(ODE::fromString(Params::getSingleton()->ODE_METHOD));
-  std::scoped_lock lock(mtxForce);
-  force = newForce;
-  forceValidityCounter = def::VALIDITY_OF_FORCE * ODE_microsteps;
+    force = newForce;
+    forceValidityCounter = def::VALIDITY_OF_FORCE;
 }
 
-Eigen::Vector3d ObjParams::getForce()
+Eigen::Vector3d ObjParams::takeForce()
 {
-    std::scoped_lock lock(mtxForce);
     if(forceValidityCounter > 0)
     {
         forceValidityCounter--;
@@ -42,87 +28,258 @@ Eigen::Vector3d ObjParams::getForce()
 }
 
 
-State::State(): logger("state.csv","time,id,PosX,PosY,PosZ,VelX,VelY,VelZ")
+static OverflowPolicy logOverflowPolicy()
+{
+    OverflowPolicy policy = OverflowPolicy::drop;
+    const Params* params = Params::getSingleton();
+    if(params != nullptr) AsyncLogger::policyFromString(params->LOG_OVERFLOW, policy);
+    return policy;
+}
+
+State::State(): logger(logOverflowPolicy(), def::LOG_BUFFER_SIZE)
 {
     status = Status::running;
     real_time = 0.0;
+    tick = 0;
     noObj = 0;
+    noSlots = 0;
+    noAwake = 0;
+    partitionDirty = false;
+    capacity = 0;
     state = Eigen::VectorXd();
+    reserve(def::INITIAL_OBJ_CAPACITY);
 }
 
 Eigen::VectorXd State::getState()
 {
-    return state;
+    return state.head(6*noSlots);
 }
 
 void State::updateState(Eigen::VectorXd newState) {
-    if(state.size() == newState.size())
+    if(newState.size() == 6*noSlots)
     {
-        state = newState;
+        state.head(6*noSlots) = newState;
     }
 }
 
 void State::updateWind(int id, Eigen::Vector3d newWind) {
-    auto iter = std::find_if(obj_params.begin(),obj_params.end(),[id](std::unique_ptr<ObjParams>& o) {return o->id == id;});
-    if(iter == obj_params.end()) return;
-    iter->get()->setWind(newWind);
+    int index = findIndex(id);
+    if(index < 0) return;
+    // object following wind field changes effective wind even if override equals stored zero wind
+    if(!obj_params[index]->hasWind() || obj_params[index]->getWind() != newWind) wake(index);
+    obj_params[index]->setWind(newWind);
+}
+
+void State::clearWind(int id)
+{
+    int index = findIndex(id);
+    if(index < 0 || !obj_params[index]->hasWind()) return;
+    wake(index);
+    obj_params[index]->clearWind();
 }
 
 void State::updateForce(int id, Eigen::Vector3d newForce) 
 {
-    auto iter = std::find_if(obj_params.begin(),obj_params.end(),[id](std::unique_ptr<ObjParams>& o) {return o->id == id;});
-    if(iter == obj_params.end()) return;
-    iter->get()->setForce(newForce);
+    int index = findIndex(id);
+    if(index < 0) return;
+    wake(index);
+    obj_params[index]->setForce(newForce);
+}
+
+void State::sleep(int index)
+{
+    ObjParams* p = obj_params[index].get();
+    if(p->asleep) return;
+    p->asleep = true;
+    p->asleepSince = tick;
+    state.segment<3>(3+6*index).setZero();
+    partitionDirty = true;
+}
+
+void State::wake(int index)
+{
+    ObjParams* p = obj_params[index].get();
+    if(!p->asleep) return;
+    p->asleep = false;
+    p->slowSteps = 0;
+    partitionDirty = true;
+}
+
+bool State::isPublished(int index)
+{
+    const ObjParams* p = obj_params[index].get();
+    if(p == nullptr) return false;
+    return !p->asleep || p->asleepSince == tick || tick % def::SLEEP_PUBLISH_INTERVAL == 0;
 }
 
 int State::addObj(double mass, double CS, Eigen::Vector3d pos,
                    Eigen::Vector3d vel) 
 {
-    static Logger obj_params_logger("params.csv", "time,id,CS");
+    return addObjWithId(ObjParams::nextId(),mass,CS,pos,vel);
+}
 
-    auto new_obj_param = std::make_unique<ObjParams>(mass,CS);
-    int id = new_obj_param->id;
-    obj_params.push_back(std::move(new_obj_param));
+int State::addObjWithId(int id, double mass, double CS, Eigen::Vector3d pos,
+                   Eigen::Vector3d vel) 
+{
+    int index;
+    if(!freeSlots.empty())
+    {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else
+    {
+        if(noSlots == capacity) reserve(2*capacity);
+        index = noSlots++;
+    }
+    obj_params[index] = std::make_unique<ObjParams>(id,mass,CS);
+    slotOfId[id] = index;
     noObj++;
-    Eigen::VectorXd newState(state.size() + 6);
-    newState << state, pos, vel;
-    state = newState;
-    obj_params_logger.log(real_time,{static_cast<double>(id), CS});
+    partitionDirty = true;
+    state.segment<3>(6*index) = pos;
+    state.segment<3>(3+6*index) = vel;
+    logger.logParams(real_time, id, CS);
     return id;
 }
 
 void State::removeObj(int id) {
-    auto iter = std::find_if(obj_params.begin(),obj_params.end(),[id](std::unique_ptr<ObjParams>& o) {return o->id == id;});
-    int index = iter - obj_params.begin();
-    if(index == noObj) return;
-    obj_params.erase(iter);
+    int index = findIndex(id);
+    if(index < 0) return;
+    slotOfId.erase(id);
+    obj_params[index].reset();
+    state.segment<6>(6*index).setZero();
+    freeSlots.push_back(index);
     noObj--;
-    Eigen::VectorXd newState(state.size() - 6);
-    newState << state.head(6*index), state.tail(6*(noObj-index));
-    state = newState;
+    partitionDirty = true;
 }
 
-std::string State::to_string()
+void State::compact()
+{
+    if(!freeSlots.empty())
+    {
+        std::sort(freeSlots.begin(),freeSlots.end());
+        for(int hole: freeSlots)
+        {
+            while(noSlots > 0 && obj_params[noSlots-1] == nullptr) noSlots--;
+            if(hole >= noSlots) break;
+            moveSlot(noSlots-1,hole);
+            noSlots--;
+        }
+        while(noSlots > 0 && obj_params[noSlots-1] == nullptr) noSlots--;
+        freeSlots.clear();
+    }
+    if(!partitionDirty) return;
+    int awake = 0, sleeping = noSlots - 1;
+    while(true)
+    {
+        while(awake <= sleeping && !obj_params[awake]->asleep) awake++;
+        while(awake <= sleeping && obj_params[sleeping]->asleep) sleeping--;
+        if(awake >= sleeping) break;
+        swapSlots(awake,sleeping);
+    }
+    noAwake = awake;
+    partitionDirty = false;
+}
+
+void State::reserve(int newCapacity)
+{
+    if(newCapacity <= capacity) return;
+    state.conservativeResize(6*newCapacity);
+    state.tail(6*(newCapacity-capacity)).setZero();
+    obj_params.resize(newCapacity);
+    freeSlots.reserve(newCapacity);
+    slotOfId.reserve(newCapacity);
+    capacity = newCapacity;
+}
+
+void State::moveSlot(int from, int to)
+{
+    obj_params[to] = std::move(obj_params[from]);
+    slotOfId[obj_params[to]->id] = to;
+    state.segment<6>(6*to) = state.segment<6>(6*from);
+    state.segment<6>(6*from).setZero();
+}
+
+void State::swapSlots(int a, int b)
+{
+    std::swap(obj_params[a],obj_params[b]);
+    slotOfId[obj_params[a]->id] = a;
+    slotOfId[obj_params[b]->id] = b;
+    state.segment<6>(6*a).swap(state.segment<6>(6*b));
+}
+
+std::string State::to_string(bool all)
 {
     static Eigen::IOFormat commaFormat(6, Eigen::DontAlignCols," ",",","","",",",";");
     std::string msg;
     msg.reserve((noObj*60 + 100));
     msg += std::to_string(real_time);
     msg.push_back(';');
-    for (int i = 0; i < noObj; i++)
+    for (int i = 0; i < noSlots; i++)
     {
+        if(!isSelected(i,all)) continue;
         msg += std::to_string(obj_params[i]->id);
         std::stringstream ss;
         ss << state.segment<6>(6*i).format(commaFormat);
         msg += ss.str();
-        logger.log(real_time,{ Eigen::Vector<double,1>(obj_params[i]->id),state.segment<6>(6*i)});
     }
     return msg;
 }
 
+void State::to_frame(std::vector<char>& frame, bool all)
+{
+    const uint32_t count = countPublished(all);
+    frame.resize(drop_frame::frameSize(count));
+    writeFrame(frame.data(), count, all);
+}
+
+size_t State::to_frame(char* out, size_t capacity)
+{
+    const uint32_t count = countPublished(false);
+    const size_t size = drop_frame::frameSize(count);
+    if(size > capacity) return 0;
+    writeFrame(out, count, false);
+    return size;
+}
+
+uint32_t State::countPublished(bool all)
+{
+    uint32_t count = 0;
+    for (int i = 0; i < noSlots; i++)
+    {
+        if(isSelected(i,all)) count++;
+    }
+    return count;
+}
+
+void State::writeFrame(char* out, uint32_t count, bool all)
+{
+    drop_frame::Header header{drop_frame::MAGIC, drop_frame::VERSION, sizeof(drop_frame::Header),
+        count, sizeof(drop_frame::Record), tick, real_time};
+    std::memcpy(out, &header, sizeof(header));
+    out += sizeof(header);
+    for (int i = 0; i < noSlots; i++)
+    {
+        if(!isSelected(i,all)) continue;
+        const uint32_t flags = obj_params[i]->asleep ? drop_frame::FLAG_SLEEPING : 0;
+        drop_frame::Record record{obj_params[i]->id, flags,
+            {state(6*i), state(6*i+1), state(6*i+2)}, {state(6*i+3), state(6*i+4), state(6*i+5)}};
+        std::memcpy(out, &record, sizeof(record));
+        out += sizeof(record);
+    }
+}
+
+void State::logState()
+{
+    for (int i = 0; i < noSlots; i++)
+    {
+        if(!isPublished(i)) continue;
+        logger.logState(real_time, tick, obj_params[i]->id, state.data() + 6*i);
+    }
+}
+
 int State::findIndex(int id)
 {
-    auto iter = std::find_if(obj_params.begin(),obj_params.end(),[id](std::unique_ptr<ObjParams>& o) {return o->id == id;});
-    int index = iter - obj_params.begin();
-    return index == noObj ? -1 : index;
+    auto iter = slotOfId.find(id);
+    return iter == slotOfId.end() ? -1 : iter->second;
 }
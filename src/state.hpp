@@ -3,11 +3,13 @@
 #include <zmq.hpp>
 #include <thread>
 #include <vector>
-#include <mutex>
 #include <atomic>
+#include <cstdint>
+#include <unordered_map>
 #include "common.hpp"
+#include "async_logger.hpp"
 
-/// @brief Single obj parameters
+/// @brief Single obj parameters. Modified only by simulation thread, between steps
 class ObjParams
 {
     public: 
@@ -17,47 +19,70 @@ class ObjParams
         const double mass;
         /// @brief aerodynamic drag force cofficent multipled by aerodynamic field 
         const double CS_coff;
+        /// @brief true if object rests and is excluded from integration
+        bool asleep = false;
+        /// @brief number of consecutive steps object was slow enough to fall asleep
+        int slowSteps = 0;
+        /// @brief tick at which object fell asleep
+        uint64_t asleepSince = 0;
        
         /// @brief Constructor
         /// @param mass object mass
         /// @param CS_coff aerodynamic drag force cofficent multipled by aerodynamic field
         ObjParams(double mass, double CS_coff):
-        id{counter++}, mass{mass}, CS_coff{CS_coff}, wind{Eigen::Vector3d()} , force{Eigen::Vector3d()}, forceValidityCounter{-1}
+        ObjParams(nextId(), mass, CS_coff)
         {   
         }
 
-        /// @brief Moving constructor
-        /// @param rhs other instant that should be consumed
-        ObjParams(ObjParams&& rhs)
-        : id{rhs.id}, mass{rhs.mass}, CS_coff{CS_coff}, wind{rhs.wind}
-        {
+        /// @brief Constructor with id reserved earlier by nextId()
+        /// @param id object id
+        /// @param mass object mass
+        /// @param CS_coff aerodynamic drag force cofficent multipled by aerodynamic field
+        ObjParams(int id, double mass, double CS_coff):
+        id{id}, mass{mass}, CS_coff{CS_coff}, wind{Eigen::Vector3d::Zero()} , force{Eigen::Vector3d::Zero()}, forceValidityCounter{-1}, windSet{false}
+        {   
         }
 
-        /// @brief Set wind vector affecting on object
+        /// @brief Moving constructor. Moves all fields, including sleep state
+        /// @param rhs other instant that should be consumed
+        ObjParams(ObjParams&& rhs) = default;
+
+        /// @brief Set wind vector affecting on object. It overrides wind field until clearWind
         /// @param newWind new wind speed vector in m/s
-        void setWind(Eigen::Vector3d newWind);
+        inline void setWind(Eigen::Vector3d newWind) {wind = newWind; windSet = true;}
+
+        /// @brief Drop wind set for object, so it follows wind field again
+        inline void clearWind() {wind = Eigen::Vector3d::Zero(); windSet = false;}
+
+        /// @brief Check if wind was set for this object
+        /// @return true if object wind overrides wind field
+        inline bool hasWind() const {return windSet;}
         
         /// @brief Get wind vector
         /// @return wind speed vector in m/s
-        Eigen::Vector3d getWind();
+        inline Eigen::Vector3d getWind() const {return wind;}
 
-        /// @brief Set outer force applied to object
+        /// @brief Set outer force applied to object for def::VALIDITY_OF_FORCE steps
         /// @param newForce new force vector in N
         void setForce(Eigen::Vector3d newForce);
 
-        /// @brief Get outer force
-        /// @return outer force vector in N
-        Eigen::Vector3d getForce();
+        /// @brief Get outer force for current step and count step down from its validity.
+        /// Should be called once per step
+        /// @return outer force vector in N, zero if force expired
+        Eigen::Vector3d takeForce();
+
+        /// @brief Reserve id for object that will be created later. Thread safe
+        /// @return unique object id
+        static inline int nextId() {return counter++;}
 
     private:
         Eigen::Vector3d wind;
-        std::mutex mtxWind;
         Eigen::Vector3d force;
-        std::atomic_int forceValidityCounter;
-        std::mutex mtxForce;
+        int forceValidityCounter;
+        bool windSet;
     
     /// @brief static counter of instances. Used to get next ID
-    static int counter;
+    static std::atomic_int counter;
 };
 
 class State
@@ -66,7 +91,7 @@ class State
         /// @brief Constructor
         State();
 
-        /// @brief Get full state as vector
+        /// @brief Get full state as vector. Covers only occupied slots
         /// @return state vector
         Eigen::VectorXd getState();
 
@@ -74,47 +99,114 @@ class State
         /// @param newState new state vector
         void updateState(Eigen::VectorXd newState);
 
-        /// @brief update wind speed for obj specified by id
+        /// @brief Get view of state of occupied slots. Allows to update state in place without copies
+        /// @return state vector block
+        inline Eigen::VectorBlock<Eigen::VectorXd> getStateView() {return state.head(6*noSlots);}
+
+        /// @brief Get view of state of awake objects, which occupy first getNoAwake() slots after compact()
+        /// @return state vector block
+        inline Eigen::VectorBlock<Eigen::VectorXd> getAwakeView() {return state.head(6*noAwake);}
+
+        /// @brief Move live objects into slots freed by removals, so occupied slots are dense again,
+        /// and move awake objects before sleeping ones. Should be called at step boundary, before integration.
+        void compact();
+
+        /// @brief Put object to sleep. It is excluded from integration from next compact() and its velocity is zeroed
+        /// @param index index of object
+        void sleep(int index);
+
+        /// @brief Wake sleeping object up. It is integrated again from next compact()
+        /// @param index index of object
+        void wake(int index);
+
+        /// @brief Check if object should be published and logged in current tick.
+        /// Sleeping objects are published on the tick they fall asleep and every def::SLEEP_PUBLISH_INTERVAL ticks
+        /// @param index index of object
+        /// @return false for free slots and silent sleeping objects
+        bool isPublished(int index);
+
+        /// @brief update wind speed for obj specified by id. Wakes object up if wind changes or object followed wind field
         /// @param id id of updated obj
         /// @param newWind new wind speed vector
         void updateWind(int id, Eigen::Vector3d newWind);
 
-        /// @brief update outer force applied to object specified by id
+        /// @brief make obj specified by id follow wind field again. Wakes object up if it had own wind
+        /// @param id id of updated obj
+        void clearWind(int id);
+
+        /// @brief update outer force applied to object specified by id. Wakes object up
         /// @param id id of updated obj
         /// @param newForce new force value
         void updateForce(int id, Eigen::Vector3d newForce);
 
-        /// @brief mutex to manipule on state responses
-        std::mutex stateMutex;
-
         /// @brief Add new object to simulation
         /// @param mass mass of object
         /// @param CS_coff aerodynamic drag force cofficent multipled by aerodynamic field 
         /// @param pos start position
         /// @param vel start velocity
         /// @return id of added object
-        int addObj(double mass, double CS_coff, Eigen::Vector3d pos, Eigen::Vector3d vel = Eigen::Vector3d());
+        int addObj(double mass, double CS_coff, Eigen::Vector3d pos, Eigen::Vector3d vel = Eigen::Vector3d::Zero());
+
+        /// @brief Add new object with id reserved by ObjParams::nextId()
+        /// @param id reserved id
+        /// @param mass mass of object
+        /// @param CS_coff aerodynamic drag force cofficent multipled by aerodynamic field 
+        /// @param pos start position
+        /// @param vel start velocity
+        /// @return id of added object
+        int addObjWithId(int id, double mass, double CS_coff, Eigen::Vector3d pos, Eigen::Vector3d vel);
 
         /// @brief remove object specified by id
         /// @param id id of removing object
         void removeObj(int id);
 
         /// @brief Serialize state to string
+        /// @param all include silent sleeping objects, e.g. for streams published less often than every tick
         /// @return serialized state
-        std::string to_string();
+        std::string to_string(bool all = false);
+
+        /// @brief Serialize state to binary frame described in state_frame.hpp
+        /// @param frame output buffer, resized to frame size. Reuse it to avoid allocations
+        /// @param all include silent sleeping objects, e.g. for streams published less often than every tick
+        void to_frame(std::vector<char>& frame, bool all = false);
+
+        /// @brief Serialize state to binary frame in memory owned by caller, e.g. shared memory slot
+        /// @param out output buffer
+        /// @param capacity size of output buffer in bytes
+        /// @return frame size in bytes, 0 if frame does not fit into buffer
+        size_t to_frame(char* out, size_t capacity);
+
+        /// @brief Pass state of all objects to trajectory log writer
+        void logState();
+
+        /// @brief Get trajectory logger, e.g. to read its counters
+        /// @return reference to logger
+        inline const AsyncLogger& getLogger() const {return logger;}
 
-        /// @brief Find index of object specified by id
+        /// @brief Find index of object specified by id. Constant time
         /// @param id object id
-        /// @return object index
+        /// @return object index, -1 if object does not exist
         int findIndex(int id);
 
         /// @brief Get number of active object in simulation
         /// @return number of object
         inline int getNoObj() {return noObj;}
 
+        /// @brief Get number of occupied slots, including holes left by removals until next compaction
+        /// @return number of slots
+        inline int getNoSlots() {return noSlots;}
+
+        /// @brief Get number of awake objects, valid after compact()
+        /// @return number of objects in first slots that are integrated
+        inline int getNoAwake() {return noAwake;}
+
+        /// @brief Get number of preallocated slots
+        /// @return slots capacity
+        inline int getCapacity() {return capacity;}
+
         /// @brief get params of object specified by index
         /// @param index index of object
-        /// @return pointer to object params
+        /// @return pointer to object params, nullptr if slot is free
         inline ObjParams* getParams(int index) {return obj_params[index].get();}
 
         /// @brief Get position of object specified by index
@@ -122,6 +214,11 @@ class State
         /// @return position vector
         inline Eigen::Vector3d getPos(int index) {return state.segment<3>(6*index);}
 
+        /// @brief Override position of object, for example after ground contact
+        /// @param index index of object
+        /// @param newPos new position vector
+        inline void setPos(int index, Eigen::Vector3d newPos) {state.segment<3>(6*index) = newPos;}
+
         /// @brief Get velocity of object specified by index
         /// @param index index of object
         /// @return velocity of object
@@ -136,14 +233,31 @@ class State
         /// @brief time of simulation
         double real_time;
 
+        /// @brief number of simulation steps done
+        uint64_t tick;
+
         /// @brief status for timed loop
         Status status;
 
 
     private:
         int noObj;
+        int noSlots;
+        int noAwake;
+        bool partitionDirty;
+        int capacity;
         Eigen::VectorXd state;
         std::vector<std::unique_ptr<ObjParams>> obj_params;
-        Logger logger;
-       
+        std::vector<int> freeSlots;
+        std::unordered_map<int,int> slotOfId;
+        AsyncLogger logger;
+
+        void reserve(int newCapacity);
+        void moveSlot(int from, int to);
+        void swapSlots(int a, int b);
+        uint32_t countPublished(bool all);
+        void writeFrame(char* out, uint32_t count, bool all);
+
+        inline bool isSelected(int index, bool all) {return all ? obj_params[index] != nullptr : isPublished(index);}
+
 };
\ No newline at end of file
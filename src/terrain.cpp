@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "terrain.hpp"
+
+Terrain::~Terrain()
+{
+    unmap();
+}
+
+void Terrain::unmap()
+{
+    for(auto& tile: tiles)
+    {
+        if(tile.data != nullptr) munmap(const_cast<float*>(tile.data), tile.bytes);
+        tile.data = nullptr;
+        tile.mapped = false;
+    }
+}
+
+bool Terrain::load(const std::string& path)
+{
+    unmap();
+    tiles.clear();
+    tilesX = 0;
+    std::ifstream in(path);
+    if(!in)
+    {
+        std::cerr << "Can not read terrain index: " << path << std::endl;
+        return false;
+    }
+    struct TileMaterial
+    {
+        int ix, iy;
+        Material material;
+    };
+    Material common;
+    std::vector<TileMaterial> overrides;
+    int sizeX = 0, sizeY = 0, side = 0;
+    double x0 = 0.0, y0 = 0.0, spacing = 0.0;
+    const std::map<std::string,double*> scalars = {
+        {"originX",&x0}, {"originY",&y0}, {"cell",&spacing},
+        {"COR",&common.COR}, {"miStatic",&common.mi_static}, {"miDynamic",&common.mi_dynamic}};
+    const std::map<std::string,int*> integers = {
+        {"tileSize",&side}, {"tilesX",&sizeX}, {"tilesY",&sizeY}};
+    std::string line;
+    while(std::getline(in, line))
+    {
+        if(line.empty() || line[0] == '#') continue;
+        const auto eq = line.find('=');
+        if(eq == std::string::npos)
+        {
+            std::cerr << "Invalid terrain index line: " << line << std::endl;
+            return false;
+        }
+        const std::string key = line.substr(0,eq), value = line.substr(eq+1);
+        try
+        {
+            if(auto it = scalars.find(key); it != scalars.end()) *it->second = std::stod(value);
+            else if(auto it = integers.find(key); it != integers.end()) *it->second = std::stoi(value);
+            else if(key == "material")
+            {
+                std::istringstream iss(value);
+                std::string s;
+                TileMaterial tm;
+                double fields[5];
+                for (int i = 0; i < 5; i++)
+                {
+                    if(!std::getline(iss, s, ',')) throw std::invalid_argument(key);
+                    fields[i] = std::stod(s);
+                }
+                tm.ix = static_cast<int>(fields[0]);
+                tm.iy = static_cast<int>(fields[1]);
+                tm.material = {fields[2], fields[3], fields[4]};
+                overrides.push_back(tm);
+            }
+            else
+            {
+                std::cerr << "Unknown terrain index key: " << key << std::endl;
+                return false;
+            }
+        }
+        catch(const std::exception&)
+        {
+            std::cerr << "Invalid terrain index value: " << line << std::endl;
+            return false;
+        }
+    }
+    if(spacing <= 0.0 || side < 1 || sizeX < 1 || sizeY < 1 || sizeX*side < 2 || sizeY*side < 2)
+    {
+        std::cerr << "Invalid terrain size in: " << path << std::endl;
+        return false;
+    }
+    dir = std::filesystem::path(path).parent_path().string();
+    if(dir.empty()) dir = ".";
+    originX = x0;
+    originY = y0;
+    cell = spacing;
+    tileSize = side;
+    tiles.resize(sizeX*sizeY);
+    for(auto& tile: tiles)
+    {
+        tile.material = common;
+    }
+    for(const auto& tm: overrides)
+    {
+        if(tm.ix < 0 || tm.ix >= sizeX || tm.iy < 0 || tm.iy >= sizeY)
+        {
+            std::cerr << "Terrain material of tile out of range: " << tm.ix << "," << tm.iy << std::endl;
+            tiles.clear();
+            return false;
+        }
+        tiles[tm.iy*sizeX + tm.ix].material = tm.material;
+    }
+    tilesX = sizeX;
+    tilesY = sizeY;
+    return true;
+}
+
+const float* Terrain::page(int ix, int iy) const
+{
+    Tile& tile = tiles[iy*tilesX + ix];
+    if(tile.mapped) return tile.data;
+    tile.mapped = true;
+    const std::string path = dir + "/tile_" + std::to_string(ix) + "_" + std::to_string(iy) + ".raw";
+    const size_t bytes = sizeof(float)*tileSize*tileSize;
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+        std::cerr << "Missing terrain tile: " << path << std::endl;
+        return nullptr;
+    }
+    struct stat st;
+    if(fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= bytes)
+    {
+        void* data = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(data != MAP_FAILED)
+        {
+            tile.data = static_cast<const float*>(data);
+            tile.bytes = bytes;
+        }
+    }
+    else
+    {
+        std::cerr << "Terrain tile too short: " << path << std::endl;
+    }
+    close(fd);
+    return tile.data;
+}
+
+double Terrain::sample(int gx, int gy) const
+{
+    const float* data = page(gx/tileSize, gy/tileSize);
+    if(data == nullptr) return std::numeric_limits<double>::quiet_NaN();
+    return data[(gy%tileSize)*tileSize + gx%tileSize];
+}
+
+double Terrain::elevation(double x, double y) const
+{
+    if(!loaded()) return std::numeric_limits<double>::quiet_NaN();
+    const double u = (x - originX)/cell, v = (y - originY)/cell;
+    const int lastX = tilesX*tileSize - 1, lastY = tilesY*tileSize - 1;
+    if(!(u >= 0.0 && v >= 0.0 && u <= lastX && v <= lastY)) return std::numeric_limits<double>::quiet_NaN();
+    const int i = std::min(static_cast<int>(u), lastX - 1), j = std::min(static_cast<int>(v), lastY - 1);
+    const double fx = u - i, fy = v - j;
+    return (1.0 - fy)*((1.0 - fx)*sample(i,j) + fx*sample(i+1,j))
+        + fy*((1.0 - fx)*sample(i,j+1) + fx*sample(i+1,j+1));
+}
+
+Eigen::Vector3d Terrain::normal(double x, double y) const
+{
+    const double u = (x - originX)/cell, v = (y - originY)/cell;
+    const int lastX = tilesX*tileSize - 1, lastY = tilesY*tileSize - 1;
+    const int i = std::clamp(static_cast<int>(u), 0, lastX - 1), j = std::clamp(static_cast<int>(v), 0, lastY - 1);
+    const double fx = std::clamp(u - i, 0.0, 1.0), fy = std::clamp(v - j, 0.0, 1.0);
+    const double h00 = sample(i,j), h10 = sample(i+1,j), h01 = sample(i,j+1), h11 = sample(i+1,j+1);
+    const double dhdx = ((1.0 - fy)*(h10 - h00) + fy*(h11 - h01))/cell;
+    const double dhdy = ((1.0 - fx)*(h01 - h00) + fx*(h11 - h10))/cell;
+    // elevation points up, axis z points down
+    return Eigen::Vector3d(-dhdx, -dhdy, -1.0).normalized();
+}
+
+const Terrain::Material& Terrain::material(double x, double y) const
+{
+    const int ix = std::clamp(static_cast<int>((x - originX)/cell)/tileSize, 0, tilesX - 1);
+    const int iy = std::clamp(static_cast<int>((y - originY)/cell)/tileSize, 0, tilesY - 1);
+    return tiles[iy*tilesX + ix].material;
+}
+
+double Terrain::clearance(const Eigen::Vector3d& pos) const
+{
+    return -pos.z() - elevation(pos.x(), pos.y());
+}
+
+bool Terrain::sweep(const Eigen::Vector3d& from, const Eigen::Vector3d& to, Hit& hit) const
+{
+    if(!loaded()) return false;
+    const Eigen::Vector3d d = to - from;
+    const int samples = 1 + static_cast<int>(std::ceil(d.head<2>().norm()/(0.5*cell)));
+    double previous = 0.0;
+    double contact = -1.0;
+    if(clearance(from) < 0.0)
+    {
+        // started below ground, e.g. added inside hill
+        contact = 0.0;
+    }
+    for (int k = 1; k <= samples && contact < 0.0; k++)
+    {
+        const double t = static_cast<double>(k)/samples;
+        if(clearance(from + t*d) < 0.0)
+        {
+            // b stays below ground, so contact has valid elevation even if segment comes from outside terrain
+            double a = previous, b = t;
+            for (int it = 0; it < 30; it++)
+            {
+                const double m = 0.5*(a + b);
+                if(clearance(from + m*d) < 0.0) b = m;
+                else a = m;
+            }
+            contact = b;
+        }
+        previous = t;
+    }
+    if(contact < 0.0) return false;
+    hit.pos = from + contact*d;
+    hit.pos.z() = -elevation(hit.pos.x(), hit.pos.y());
+    hit.normal = normal(hit.pos.x(), hit.pos.y());
+    hit.material = material(hit.pos.x(), hit.pos.y());
+    return true;
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <Eigen/Dense>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/// @brief Ground heightmap split into square tiles of raw float32 elevations.
+/// Tiles are memory-mapped on first access, so only visited part of terrain is read from disk.
+/// Terrain is described by "key=value" index file, lines starting with '#' are ignored:
+/// originX, originY - position of first sample in m;
+/// cell - distance between samples in m;
+/// tileSize - samples along tile side;
+/// tilesX, tilesY - number of tiles;
+/// COR, miStatic, miDynamic - default material;
+/// material=<ix>,<iy>,<COR>,<miStatic>,<miDynamic> - material of single tile, may repeat.
+/// Tile (ix,iy) is read from "tile_<ix>_<iy>.raw" next to index file. It holds tileSize x tileSize
+/// elevations in m, rows along y. Elevation points up, so ground z is -elevation.
+class Terrain
+{
+    public:
+        /// @brief Collision response of ground, same meaning as in Engine::calcImpulseForce
+        struct Material
+        {
+            double COR = 0.3;
+            double mi_static = 0.6;
+            double mi_dynamic = 0.4;
+        };
+
+        /// @brief Point where segment enters ground
+        struct Hit
+        {
+            /// @brief contact point on surface
+            Eigen::Vector3d pos;
+            /// @brief unit surface normal, pointing out of ground
+            Eigen::Vector3d normal;
+            /// @brief material of tile
+            Material material;
+        };
+
+        /// @brief Constructor. Terrain is empty until loaded
+        Terrain() = default;
+
+        Terrain(const Terrain&) = delete; // no copies
+        Terrain& operator=(const Terrain&) = delete; // no self-assignments
+
+        /// @brief Deconstructor. Unmaps tiles
+        ~Terrain();
+
+        /// @brief Read index file. Tiles are mapped later, when needed
+        /// @param path path of index file
+        /// @return false if index is invalid
+        bool load(const std::string& path);
+
+        /// @brief Check if terrain was loaded
+        inline bool loaded() const {return tilesX > 0;}
+
+        /// @brief Get ground elevation
+        /// @param x x coordinate in m
+        /// @param y y coordinate in m
+        /// @return elevation in m, NaN outside terrain or in tile without file
+        double elevation(double x, double y) const;
+
+        /// @brief Find first point where segment goes below ground. Segment is sampled with half cell step
+        /// @param from segment start, e.g. position before step
+        /// @param to segment end, e.g. position after step
+        /// @param hit output
+        /// @return true if segment enters ground
+        bool sweep(const Eigen::Vector3d& from, const Eigen::Vector3d& to, Hit& hit) const;
+
+        /// @brief Get material of ground at given point
+        const Material& material(double x, double y) const;
+
+    private:
+        struct Tile
+        {
+            const float* data = nullptr;
+            size_t bytes = 0;
+            bool mapped = false;
+            Material material;
+        };
+
+        std::string dir;
+        double originX = 0.0, originY = 0.0, cell = 1.0;
+        int tileSize = 0, tilesX = 0, tilesY = 0;
+        mutable std::vector<Tile> tiles;
+
+        const float* page(int ix, int iy) const;
+        double sample(int gx, int gy) const;
+        double clearance(const Eigen::Vector3d& pos) const;
+        Eigen::Vector3d normal(double x, double y) const;
+        void unmap();
+};
@@ -0,0 +1,82 @@
+#include <algorithm>
+#include "thread_pool.hpp"
+
+ThreadPool::ThreadPool(int threads)
+    : ranges(threads > 0 ? threads : std::max(1u,std::thread::hardware_concurrency())),
+    generation{0}, running{true}, invoke{nullptr}, ctx{nullptr}, done{0}, active{0}
+{
+    for (int i = 1; i < size(); i++)
+    {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::scoped_lock lock(mtx);
+        running = false;
+    }
+    wakeCv.notify_all();
+    for(auto& worker: workers)
+    {
+        worker.join();
+    }
+}
+
+void ThreadPool::run(int tasks, void (*fn)(void*, int), void* context)
+{
+    if(tasks <= 0) return;
+    const int participants = size();
+    {
+        std::scoped_lock lock(mtx);
+        invoke = fn;
+        ctx = context;
+        for (int i = 0; i < participants; i++)
+        {
+            ranges[i].next.store(static_cast<long>(tasks)*i/participants, std::memory_order_relaxed);
+            ranges[i].end = static_cast<long>(tasks)*(i+1)/participants;
+        }
+        done.store(0, std::memory_order_relaxed);
+        active.store(participants - 1, std::memory_order_relaxed);
+        generation++;
+    }
+    wakeCv.notify_all();
+    work(0);
+    while(done.load(std::memory_order_acquire) < tasks || active.load(std::memory_order_acquire) > 0)
+    {
+        std::this_thread::yield();
+    }
+}
+
+void ThreadPool::work(int self)
+{
+    const int participants = size();
+    int finished = 0;
+    for (int k = 0; k < participants; k++)
+    {
+        Range& range = ranges[(self + k) % participants];
+        for(int task = range.next.fetch_add(1); task < range.end; task = range.next.fetch_add(1))
+        {
+            invoke(ctx, task);
+            finished++;
+        }
+    }
+    done.fetch_add(finished, std::memory_order_acq_rel);
+}
+
+void ThreadPool::workerLoop(int self)
+{
+    unsigned seen = 0;
+    while(true)
+    {
+        {
+            std::unique_lock lock(mtx);
+            wakeCv.wait(lock, [&]() {return generation != seen || !running;});
+            if(!running) return;
+            seen = generation;
+        }
+        work(self);
+        active.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// @brief Persistent pool of worker threads for data parallel loops.
+/// Every participant gets contiguous range of tasks and steals from ranges of others when its own is done.
+/// Calling thread takes part in work. Dispatch does not allocate memory.
+class ThreadPool
+{
+    public:
+        /// @brief Constructor. Starts threads - 1 workers
+        /// @param threads number of threads taking part in loops, including calling thread. 0 means hardware concurrency
+        ThreadPool(int threads);
+
+        ThreadPool(const ThreadPool&) = delete; // no copies
+        ThreadPool& operator=(const ThreadPool&) = delete; // no self-assignments
+
+        /// @brief Deconstructor. Stops workers
+        ~ThreadPool();
+
+        /// @brief Get number of threads taking part in loops
+        inline int size() const {return static_cast<int>(ranges.size());}
+
+        /// @brief Call f(i) for every i in [0, tasks) and wait for all calls. Calls can run concurrently in any order
+        /// @param tasks number of tasks
+        /// @param f function called for every task
+        template<typename F>
+        void parallelFor(int tasks, F& f)
+        {
+            run(tasks, [](void* ctx, int task) {(*static_cast<F*>(ctx))(task);}, &f);
+        }
+
+    private:
+        struct alignas(64) Range
+        {
+            std::atomic_int next;
+            int end;
+        };
+
+        std::vector<Range> ranges;
+        std::vector<std::thread> workers;
+        std::mutex mtx;
+        std::condition_variable wakeCv;
+        unsigned generation;
+        bool running;
+        void (*invoke)(void*, int);
+        void* ctx;
+        std::atomic_int done;
+        std::atomic_int active;
+
+        void run(int tasks, void (*fn)(void*, int), void* context);
+        void work(int self);
+        void workerLoop(int self);
+};
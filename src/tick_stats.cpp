@@ -0,0 +1,86 @@
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include "tick_stats.hpp"
+
+int LatencyHistogram::bucket(uint64_t ns)
+{
+    if(ns < 16) return static_cast<int>(ns);
+    const int shift = std::bit_width(ns) - 5;
+    return std::min(16*shift + static_cast<int>(ns >> shift), BUCKETS - 1);
+}
+
+uint64_t LatencyHistogram::upperBound(int bucket)
+{
+    if(bucket < 16) return bucket;
+    const int shift = bucket/16 - 1;
+    const uint64_t mantissa = bucket%16 + 16;
+    return ((mantissa + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t ns)
+{
+    // single writer, so plain load and store are enough
+    auto& b = buckets[bucket(ns)];
+    b.store(b.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    samples.store(samples.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if(ns > largest.load(std::memory_order_relaxed)) largest.store(ns, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::quantile(double q) const
+{
+    const uint64_t total = count();
+    if(total == 0) return 0;
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(q*total + 0.5));
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS; i++)
+    {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if(seen >= rank) return std::min(upperBound(i), max());
+    }
+    return max();
+}
+
+TickStats::TickStats(double budget)
+    : budget{std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(budget))}
+{
+}
+
+void TickStats::end(int queueDepth)
+{
+    const auto duration = Clock::now() - start;
+    phases[tick].record(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+    if(duration > budget) overruns.store(overruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    lastQueue.store(queueDepth, std::memory_order_relaxed);
+    if(queueDepth > maxQueue.load(std::memory_order_relaxed)) maxQueue.store(queueDepth, std::memory_order_relaxed);
+}
+
+const char* TickStats::phaseName(Phase phase)
+{
+    static const char* names[PHASES] = {"commands", "integration", "logging", "serialization",
+        "publishing", "prediction", "tick"};
+    return names[phase];
+}
+
+std::string TickStats::report() const
+{
+    char line[160];
+    std::snprintf(line, sizeof(line), "ticks=%llu;overruns=%llu;queue=%d,%d",
+        static_cast<unsigned long long>(phases[tick].count()), static_cast<unsigned long long>(getOverruns()),
+        lastQueue.load(std::memory_order_relaxed), getMaxQueueDepth());
+    std::string res = line;
+    for (int i = 0; i < PHASES; i++)
+    {
+        const LatencyHistogram& h = phases[i];
+        std::snprintf(line, sizeof(line), "\n%s=%.3f,%.3f,%.3f,%.3f", phaseName(static_cast<Phase>(i)),
+            h.quantile(0.5)/1000.0, h.quantile(0.9)/1000.0, h.quantile(0.99)/1000.0, h.max()/1000.0);
+        res += line;
+    }
+    if(log != nullptr)
+    {
+        std::snprintf(line, sizeof(line), "\nlog=%llu,%llu", static_cast<unsigned long long>(log->getWritten()),
+            static_cast<unsigned long long>(log->getDropped()));
+        res += line;
+    }
+    return res;
+}
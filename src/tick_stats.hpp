@@ -0,0 +1,119 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include "async_logger.hpp"
+
+/// @brief Histogram of latencies with logarithmic buckets, each octave split into 16
+/// linear sub-buckets, so relative error stays below 7% from nanoseconds to minutes.
+/// Single writer, many readers. Readers see approximate snapshot.
+class LatencyHistogram
+{
+    public:
+        /// @brief Number of buckets, covers values up to 2^40 ns
+        static constexpr int BUCKETS = 16*38;
+
+        /// @brief Add sample
+        /// @param ns latency in ns
+        void record(uint64_t ns);
+
+        /// @brief Get number of samples
+        inline uint64_t count() const {return samples.load(std::memory_order_relaxed);}
+
+        /// @brief Get largest sample
+        inline uint64_t max() const {return largest.load(std::memory_order_relaxed);}
+
+        /// @brief Get value below which given fraction of samples lies
+        /// @param q quantile, between 0 and 1
+        /// @return upper bound of bucket containing quantile in ns, 0 if there are no samples
+        uint64_t quantile(double q) const;
+
+        /// @brief Get bucket of value
+        static int bucket(uint64_t ns);
+
+        /// @brief Get largest value in bucket
+        static uint64_t upperBound(int bucket);
+
+    private:
+        std::array<std::atomic<uint64_t>,BUCKETS> buckets{};
+        std::atomic<uint64_t> samples{0};
+        std::atomic<uint64_t> largest{0};
+};
+
+/// @brief Per phase timers of simulation tick. Phases are measured as laps between consecutive calls,
+/// so each boundary costs single clock read.
+class TickStats
+{
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        /// @brief Phase of tick
+        enum Phase
+        {
+            commands,
+            integration,
+            logging,
+            serialization,
+            publishing,
+            prediction,
+            tick,
+            PHASES
+        };
+
+        /// @brief Constructor
+        /// @param budget tick duration in s. Longer ticks are counted as overruns
+        TickStats(double budget);
+
+        /// @brief Start timing of tick
+        inline void begin()
+        {
+            start = Clock::now();
+            last = start;
+        }
+
+        /// @brief End phase started at the end of previous phase or at begin
+        /// @param phase finished phase
+        inline void lap(Phase phase)
+        {
+            const auto now = Clock::now();
+            phases[phase].record(std::chrono::duration_cast<std::chrono::nanoseconds>(now - last).count());
+            last = now;
+        }
+
+        /// @brief End timing of tick
+        /// @param queueDepth number of commands applied in this tick
+        void end(int queueDepth);
+
+        /// @brief Get latency histogram of phase
+        inline const LatencyHistogram& getPhase(Phase phase) const {return phases[phase];}
+
+        /// @brief Get number of ticks longer than budget
+        inline uint64_t getOverruns() const {return overruns.load(std::memory_order_relaxed);}
+
+        /// @brief Get largest number of commands applied in one tick
+        inline int getMaxQueueDepth() const {return maxQueue.load(std::memory_order_relaxed);}
+
+        /// @brief Get phase name
+        static const char* phaseName(Phase phase);
+
+        /// @brief Report counters of trajectory logger too, so samples dropped by overflow policy are visible while running
+        /// @param logger logger that outlives stats
+        inline void attachLogger(const AsyncLogger& logger) {log = &logger;}
+
+        /// @brief Make human and machine readable report. Thread safe.
+        /// First line: "ticks=<n>;overruns=<n>;queue=<last>,<max>", then one line per phase:
+        /// "<phase>=<p50>,<p90>,<p99>,<max>" in us, and "log=<written>,<dropped>" samples if logger is attached
+        /// @return report
+        std::string report() const;
+
+    private:
+        const Clock::duration budget;
+        Clock::time_point start, last;
+        std::array<LatencyHistogram,PHASES> phases;
+        std::atomic<uint64_t> overruns{0};
+        std::atomic_int lastQueue{0};
+        std::atomic_int maxQueue{0};
+        const AsyncLogger* log = nullptr;
+};
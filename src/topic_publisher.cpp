@@ -0,0 +1,157 @@
+#include <charconv>
+#include <sstream>
+#include "topic_publisher.hpp"
+#include "defines.hpp"
+
+namespace
+{
+    /// @brief Append integer without temporary string
+    void appendInt(std::string& out, long value)
+    {
+        char buffer[24];
+        auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.append(buffer, end);
+    }
+
+    /// @brief Append number formatted as by State::to_string
+    void appendDouble(std::string& out, double value, std::chars_format format)
+    {
+        char buffer[64];
+        auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value, format, 6);
+        out.append(buffer, end);
+    }
+}
+
+TopicPublisher::TopicPublisher(const std::string& regionSpec, double deltaThreshold, bool all)
+    : _valid{parseRegions(regionSpec, regions)}, threshold{deltaThreshold}, all{all}, count{0}, updates{0}
+{
+    regionPayloads.resize(regions.size());
+}
+
+bool TopicPublisher::parseRegions(const std::string& spec, std::vector<Region>& regions)
+{
+    std::istringstream items(spec);
+    std::string item;
+    while(std::getline(items, item, ';'))
+    {
+        if(item.empty()) continue;
+        std::istringstream fields(item);
+        Region region;
+        std::string field;
+        double values[6];
+        if(!std::getline(fields, region.name, ',') || region.name.empty()
+            || region.name.find('|') != std::string::npos)
+        {
+            return false;
+        }
+        for (int i = 0; i < 6; i++)
+        {
+            if(!std::getline(fields, field, ',')) return false;
+            auto [end, ec] = std::from_chars(field.data(), field.data() + field.size(), values[i]);
+            if(ec != std::errc() || end != field.data() + field.size()) return false;
+        }
+        if(std::getline(fields, field, ',')) return false;
+        region.min = Eigen::Vector3d(values[0], values[1], values[2]);
+        region.max = Eigen::Vector3d(values[3], values[4], values[5]);
+        if((region.min.array() > region.max.array()).any()) return false;
+        regions.push_back(region);
+    }
+    return true;
+}
+
+TopicPublisher::Message& TopicPublisher::next()
+{
+    if(count == messages.size()) messages.emplace_back();
+    Message& message = messages[count++];
+    message.topic.clear();
+    message.payload.clear();
+    return message;
+}
+
+void TopicPublisher::update(State& state)
+{
+    const bool delta = threshold > 0.0;
+    const bool key = !delta || updates % def::KEYFRAME_INTERVAL == 0;
+    updates++;
+    count = 0;
+    next().topic = "t|";
+    std::string time;
+    appendDouble(time, state.real_time, std::chars_format::fixed);
+    time.push_back(';');
+    for(auto& payload: regionPayloads)
+    {
+        payload = time;
+    }
+    const double threshold2 = threshold*threshold;
+    size_t seen = 0;
+    for (int i = 0; i < state.getNoSlots(); i++)
+    {
+        const ObjParams* p = state.getParams(i);
+        if(p == nullptr) continue;
+        seen++;
+        const Eigen::Vector3d pos = state.getPos(i), vel = state.getVel(i);
+        auto [it, inserted] = sent.try_emplace(p->id, Sent{pos, vel, 0});
+        Sent& last = it->second;
+        last.seen = updates;
+        const bool send = delta
+            ? inserted || key || (pos - last.pos).squaredNorm() > threshold2 || (vel - last.vel).squaredNorm() > threshold2
+            : all || state.isPublished(i);
+        if(!send) continue;
+        last.pos = pos;
+        last.vel = vel;
+        line.clear();
+        appendInt(line, p->id);
+        for(double value: {pos.x(), pos.y(), pos.z(), vel.x(), vel.y(), vel.z()})
+        {
+            line.push_back(',');
+            appendDouble(line, value, std::chars_format::general);
+        }
+        line.push_back(';');
+        Message& object = next();
+        object.topic = "o/";
+        appendInt(object.topic, p->id);
+        object.topic.push_back('|');
+        object.payload = time;
+        object.payload += line;
+        for (size_t r = 0; r < regions.size(); r++)
+        {
+            if((pos.array() >= regions[r].min.array()).all() && (pos.array() <= regions[r].max.array()).all())
+            {
+                regionPayloads[r] += line;
+            }
+        }
+    }
+    removed.clear();
+    if(sent.size() > seen)
+    {
+        for (auto it = sent.begin(); it != sent.end();)
+        {
+            if(it->second.seen == updates)
+            {
+                ++it;
+                continue;
+            }
+            removed.push_back(it->first);
+            it = sent.erase(it);
+        }
+    }
+    std::string& tick = messages[0].payload;
+    appendInt(tick, state.tick);
+    tick.push_back(';');
+    tick += time;
+    tick += key ? "key;" : "delta;";
+    for (size_t i = 0; i < removed.size(); i++)
+    {
+        if(i > 0) tick.push_back(',');
+        appendInt(tick, removed[i]);
+    }
+    for (size_t r = 0; r < regions.size(); r++)
+    {
+        if(!key && regionPayloads[r].size() == time.size()) continue;
+        Message& region = next();
+        region.topic = "r/";
+        region.topic += regions[r].name;
+        region.topic.push_back('|');
+        region.payload = regionPayloads[r];
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <Eigen/Dense>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "state.hpp"
+
+/// @brief Splits state into messages with ZMQ topics, so subscribers receive only objects they care about.
+/// Every tick produces messages in this order:
+/// "t|" - "<tick>;<time>;<key|delta>;<removed ids separated by ','>", removed ids are objects gone since last update;
+/// "o/<id>|" - one object, payload has format of State::to_string, e.g. "1.500000;7,x,y,z,vx,vy,vz;";
+/// "r/<name>|" - all objects inside region, same format. Sent only if it is not empty or in keyframe.
+/// Topics end with '|', so subscription to "o/1|" does not match object 12.
+/// Without delta threshold all published objects (see State::isPublished) are sent and every update is a keyframe.
+/// With threshold only objects whose position in m or velocity in m/s moved more than threshold since they
+/// were sent last time are sent, and all objects are sent in keyframe every def::KEYFRAME_INTERVAL updates
+class TopicPublisher
+{
+    public:
+        /// @brief Axis aligned box of interest
+        struct Region
+        {
+            std::string name;
+            Eigen::Vector3d min;
+            Eigen::Vector3d max;
+        };
+
+        /// @brief Single ZMQ message
+        struct Message
+        {
+            std::string topic;
+            std::string payload;
+        };
+
+        /// @brief Constructor
+        /// @param regionSpec regions of interest, see parseRegions
+        /// @param deltaThreshold change needed to send object again, 0 sends all objects every update
+        /// @param all without delta, send also silent sleeping objects
+        TopicPublisher(const std::string& regionSpec, double deltaThreshold, bool all = false);
+
+        /// @brief Check if regions were parsed
+        /// @return false if region spec is invalid
+        inline bool valid() const {return _valid;}
+
+        /// @brief Parse regions given as "name,xmin,ymin,zmin,xmax,ymax,zmax" separated by ';'
+        /// @param spec regions description, may be empty
+        /// @param regions output
+        /// @return false if spec is invalid
+        static bool parseRegions(const std::string& spec, std::vector<Region>& regions);
+
+        /// @brief Build messages of current tick. Buffers are reused between ticks
+        /// @param state simulation state
+        void update(State& state);
+
+        /// @brief Get number of messages built by last update
+        inline size_t size() const {return count;}
+
+        /// @brief Get message built by last update
+        /// @param i message index, lower than size()
+        inline const Message& at(size_t i) const {return messages[i];}
+
+    private:
+        struct Sent
+        {
+            Eigen::Vector3d pos, vel;
+            uint64_t seen;
+        };
+
+        std::vector<Region> regions;
+        bool _valid;
+        double threshold;
+        bool all;
+        std::unordered_map<int,Sent> sent;
+        std::vector<Message> messages;
+        std::vector<std::string> regionPayloads;
+        std::vector<int> removed;
+        std::string line;
+        size_t count;
+        uint64_t updates;
+
+        Message& next();
+};
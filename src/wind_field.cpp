@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "wind_field.hpp"
+
+namespace
+{
+    const char MAGIC[4] = {'D','W','F','1'};
+
+    /// @brief Size of file header in bytes
+    const size_t HEADER_SIZE = 4 + 5*sizeof(uint32_t) + 8*sizeof(double);
+
+    /// @brief Find interpolation cell along one axis, clamped to grid. Not finite coordinate gives first node
+    inline void locate(double coord, double origin, double spacing, int n, int& i, double& f)
+    {
+        double u = (coord - origin)/spacing;
+        // written so that NaN fails comparison and never reaches conversion to int
+        u = u > 0.0 ? std::min(u, static_cast<double>(n - 1)) : 0.0;
+        i = std::min(static_cast<int>(u), std::max(n - 2, 0));
+        f = n > 1 ? u - i : 0.0;
+    }
+}
+
+WindField::~WindField()
+{
+    unmap();
+}
+
+void WindField::unmap()
+{
+    if(mapping != nullptr) munmap(mapping, bytes);
+    mapping = nullptr;
+    data = nullptr;
+    bytes = 0;
+}
+
+bool WindField::load(const std::string& path)
+{
+    unmap();
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+        std::cerr << "Can not open wind field: " << path << std::endl;
+        return false;
+    }
+    struct stat st;
+    if(fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < HEADER_SIZE)
+    {
+        std::cerr << "Wind field too short: " << path << std::endl;
+        close(fd);
+        return false;
+    }
+    bytes = st.st_size;
+    mapping = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(mapping == MAP_FAILED)
+    {
+        mapping = nullptr;
+        std::cerr << "Can not map wind field: " << path << std::endl;
+        return false;
+    }
+    const char* raw = static_cast<const char*>(mapping);
+    uint32_t dims[5];
+    double values[8];
+    std::memcpy(dims, raw + 4, sizeof(dims));
+    std::memcpy(values, raw + 4 + sizeof(dims), sizeof(values));
+    Grid g;
+    g.nx = dims[0];
+    g.ny = dims[1];
+    g.nz = dims[2];
+    g.nt = dims[3];
+    g.origin = Eigen::Vector3d(values[0], values[1], values[2]);
+    g.spacing = Eigen::Vector3d(values[3], values[4], values[5]);
+    g.t0 = values[6];
+    g.dt = values[7];
+    // dimensions are checked one by one against file size, so neither int fields nor node count overflow
+    size_t nodes = 1;
+    bool dimsValid = true;
+    for (int d = 0; d < 4; d++)
+    {
+        dimsValid = dimsValid && dims[d] > 0 && nodes <= bytes/(3*sizeof(float))/dims[d];
+        if(dimsValid) nodes *= dims[d];
+    }
+    bool valuesValid = true;
+    for(double value: values)
+    {
+        valuesValid = valuesValid && std::isfinite(value);
+    }
+    if(std::memcmp(raw, MAGIC, 4) != 0 || !dimsValid || !valuesValid || (g.spacing.array() <= 0.0).any() || g.dt <= 0.0
+        || bytes < HEADER_SIZE + 3*sizeof(float)*nodes)
+    {
+        std::cerr << "Invalid wind field: " << path << std::endl;
+        unmap();
+        return false;
+    }
+    grid = g;
+    data = reinterpret_cast<const float*>(raw + HEADER_SIZE);
+    return true;
+}
+
+bool WindField::save(const std::string& path, const Grid& g, const std::vector<float>& wind)
+{
+    if(wind.size() != 3*static_cast<size_t>(g.nx)*g.ny*g.nz*g.nt) return false;
+    std::ofstream out(path, std::ios::binary);
+    const uint32_t dims[5] = {static_cast<uint32_t>(g.nx), static_cast<uint32_t>(g.ny),
+        static_cast<uint32_t>(g.nz), static_cast<uint32_t>(g.nt), 0};
+    const double values[8] = {g.origin.x(), g.origin.y(), g.origin.z(),
+        g.spacing.x(), g.spacing.y(), g.spacing.z(), g.t0, g.dt};
+    out.write(MAGIC, 4);
+    out.write(reinterpret_cast<const char*>(dims), sizeof(dims));
+    out.write(reinterpret_cast<const char*>(values), sizeof(values));
+    out.write(reinterpret_cast<const char*>(wind.data()), wind.size()*sizeof(float));
+    return static_cast<bool>(out);
+}
+
+WindField::Frame WindField::at(double t) const
+{
+    int slice;
+    double weight;
+    locate(t, grid.t0, grid.dt, grid.nt, slice, weight);
+    const size_t sliceSize = 3*static_cast<size_t>(grid.nx)*grid.ny*grid.nz;
+    Frame frame;
+    frame.grid = &grid;
+    frame.before = data + slice*sliceSize;
+    frame.after = grid.nt > 1 ? frame.before + sliceSize : frame.before;
+    frame.weight = weight;
+    return frame;
+}
+
+Eigen::Vector3d WindField::Frame::operator()(const Eigen::Vector3d& pos) const
+{
+    const Grid& g = *grid;
+    int i, j, k;
+    double fx, fy, fz;
+    locate(pos.x(), g.origin.x(), g.spacing.x(), g.nx, i, fx);
+    locate(pos.y(), g.origin.y(), g.spacing.y(), g.ny, j, fy);
+    locate(pos.z(), g.origin.z(), g.spacing.z(), g.nz, k, fz);
+    const size_t sx = g.nx > 1 ? 3 : 0;
+    const size_t sy = g.ny > 1 ? 3*static_cast<size_t>(g.nx) : 0;
+    const size_t sz = g.nz > 1 ? 3*static_cast<size_t>(g.nx)*g.ny : 0;
+    const size_t base = 3*((static_cast<size_t>(k)*g.ny + j)*g.nx + i);
+    const double w[8] = {
+        (1.0 - fx)*(1.0 - fy)*(1.0 - fz), fx*(1.0 - fy)*(1.0 - fz),
+        (1.0 - fx)*fy*(1.0 - fz), fx*fy*(1.0 - fz),
+        (1.0 - fx)*(1.0 - fy)*fz, fx*(1.0 - fy)*fz,
+        (1.0 - fx)*fy*fz, fx*fy*fz};
+    const size_t offsets[8] = {0, sx, sy, sx + sy, sz, sz + sx, sz + sy, sz + sx + sy};
+    double res[3] = {0.0, 0.0, 0.0};
+    for (int c = 0; c < 8; c++)
+    {
+        const float* a = before + base + offsets[c];
+        const float* b = after + base + offsets[c];
+        const double wa = w[c]*(1.0 - weight), wb = w[c]*weight;
+        for (int d = 0; d < 3; d++)
+        {
+            res[d] += wa*a[d] + wb*b[d];
+        }
+    }
+    return Eigen::Vector3d(res[0], res[1], res[2]);
+}
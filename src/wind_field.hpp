@@ -0,0 +1,87 @@
+#pragma once
+#include <Eigen/Dense>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// @brief Wind given on regular 3D grid in several time slices, read from memory-mapped binary file.
+/// File layout (little endian): magic "DWF1", uint32 nx, ny, nz, nt, uint32 reserved,
+/// double originX, originY, originZ, dx, dy, dz, t0, dt, then nt*nz*ny*nx float32 triples (wx,wy,wz)
+/// with x changing fastest. Grid uses simulation coordinates, axis z points down.
+/// Between nodes wind is interpolated trilinearly in space and linearly in time.
+/// Outside grid and time range nearest boundary value is used.
+class WindField
+{
+    public:
+        /// @brief Grid description
+        struct Grid
+        {
+            int nx = 0, ny = 0, nz = 0, nt = 0;
+            /// @brief position of first node
+            Eigen::Vector3d origin = Eigen::Vector3d::Zero();
+            /// @brief distance between nodes along axes in m
+            Eigen::Vector3d spacing = Eigen::Vector3d::Ones();
+            /// @brief time of first slice in s
+            double t0 = 0.0;
+            /// @brief time between slices in s
+            double dt = 1.0;
+        };
+
+        /// @brief Wind field frozen at given time. Cheap to copy, valid while field is loaded
+        class Frame
+        {
+            public:
+                /// @brief Get wind at position
+                /// @param pos position
+                /// @return wind speed vector in m/s
+                Eigen::Vector3d operator()(const Eigen::Vector3d& pos) const;
+
+            private:
+                friend class WindField;
+                const Grid* grid = nullptr;
+                const float* before = nullptr;
+                const float* after = nullptr;
+                double weight = 0.0;
+        };
+
+        /// @brief Constructor. Field is empty until loaded
+        WindField() = default;
+
+        WindField(const WindField&) = delete; // no copies
+        WindField& operator=(const WindField&) = delete; // no self-assignments
+
+        /// @brief Deconstructor. Unmaps file
+        ~WindField();
+
+        /// @brief Map field file
+        /// @param path path of file
+        /// @return false if file can not be mapped or is invalid
+        bool load(const std::string& path);
+
+        /// @brief Check if field was loaded
+        inline bool loaded() const {return data != nullptr;}
+
+        /// @brief Get grid description
+        inline const Grid& getGrid() const {return grid;}
+
+        /// @brief Get field at given time. Time interpolation is done once for all positions
+        /// @param t simulation time in s
+        /// @return frame
+        Frame at(double t) const;
+
+        /// @brief Write field file
+        /// @param path path of file
+        /// @param grid grid description
+        /// @param wind 3*nt*nz*ny*nx wind components in file order
+        /// @return false if file can not be written or wind has wrong size
+        static bool save(const std::string& path, const Grid& grid, const std::vector<float>& wind);
+
+    private:
+        Grid grid;
+        void* mapping = nullptr;
+        size_t bytes = 0;
+        const float* data = nullptr;
+
+        void unmap();
+};
@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+#include "async_logger.hpp"
+
+/// Fill logger faster than writer thread can flush
+void burst(AsyncLogger& logger, int samples)
+{
+    const double state[6] = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+    for (int i = 0; i < samples; i++)
+    {
+        logger.logState(0.003*i, i, i % 7, state);
+    }
+}
+
+/// Drop policy should count discarded samples instead of waiting
+TEST(AsyncLoggerTest, DropPolicyCountsDroppedSamples) {
+    uint64_t dropped;
+    {
+        AsyncLogger logger(OverflowPolicy::drop, 16);
+        burst(logger, 1000);
+        dropped = logger.getDropped();
+    }
+    EXPECT_GT(dropped, 0u);
+    EXPECT_LE(dropped, 1000u - 16u);
+}
+
+/// Block policy should never lose samples
+TEST(AsyncLoggerTest, BlockPolicyKeepsAllSamples) {
+    AsyncLogger logger(OverflowPolicy::block, 16);
+    burst(logger, 1000);
+    EXPECT_EQ(logger.getDropped(), 0u);
+}
+
+/// Decimate policy should keep logging some samples under pressure
+TEST(AsyncLoggerTest, DecimatePolicyThinsOutSamples) {
+    AsyncLogger logger(OverflowPolicy::decimate, 64);
+    burst(logger, 1000);
+    EXPECT_GT(logger.getDropped(), 0u);
+    EXPECT_LT(logger.getDropped(), 1000u);
+}
+
+/// Policy names used on command line
+TEST(AsyncLoggerTest, ParsesPolicyNames) {
+    OverflowPolicy policy;
+    EXPECT_TRUE(AsyncLogger::policyFromString("block", policy));
+    EXPECT_EQ(policy, OverflowPolicy::block);
+    EXPECT_TRUE(AsyncLogger::policyFromString("decimate", policy));
+    EXPECT_EQ(policy, OverflowPolicy::decimate);
+    EXPECT_FALSE(AsyncLogger::policyFromString("fast", policy));
+}
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <Eigen/Dense>
+#include <limits>
+#include <vector>
+#include "atmosphere.hpp"
+#include "engine.hpp"
+#include "params.hpp"
+#include "defines.hpp"
+
+/// Analytic model should match published 1976 standard atmosphere tables
+TEST(AtmosphereTest, AnalyticMatchesStandardTables) {
+    EXPECT_NEAR(isa::temperature(0.0), 288.15, 1e-9);
+    EXPECT_NEAR(isa::pressure(0.0), 101325.0, 1e-6);
+    EXPECT_NEAR(isa::density(0.0), 1.2250, 1e-4);
+    EXPECT_NEAR(isa::speedOfSound(0.0), 340.29, 1e-2);
+    EXPECT_NEAR(isa::temperature(10000.0), 223.25, 1e-2);
+    EXPECT_NEAR(isa::density(10000.0), 0.41351, 1e-4);
+    EXPECT_NEAR(isa::pressure(20000.0), 5529.3, 1.0);
+    EXPECT_NEAR(isa::density(30000.0), 0.018410, 1e-5);
+    EXPECT_NEAR(isa::temperature(50000.0), 270.65, 1e-2);
+    EXPECT_NEAR(isa::density(80000.0), 1.846e-5, 1e-7);
+}
+
+/// Interpolated tables should stay close to analytic formulas in whole range.
+/// Error is largest next to layer borders, where temperature gradient changes
+TEST(AtmosphereTest, TableMatchesAnalytic) {
+    Atmosphere atmosphere("ISA");
+    ASSERT_TRUE(atmosphere.valid());
+    EXPECT_FALSE(atmosphere.constant());
+    for (double h = def::ATMOSPHERE_MIN_ALTITUDE; h <= def::ATMOSPHERE_MAX_ALTITUDE; h += 37.3)
+    {
+        EXPECT_NEAR(atmosphere.density(h), isa::density(h), 3e-4*isa::density(h)) << h;
+        EXPECT_NEAR(atmosphere.temperature(h), isa::temperature(h), 0.05) << h;
+        EXPECT_NEAR(atmosphere.speedOfSound(h), isa::speedOfSound(h), 0.05) << h;
+    }
+    // nearest end outside table
+    EXPECT_DOUBLE_EQ(atmosphere.density(1e6), atmosphere.density(def::ATMOSPHERE_MAX_ALTITUDE));
+    EXPECT_DOUBLE_EQ(atmosphere.density(-1e6), atmosphere.density(def::ATMOSPHERE_MIN_ALTITUDE));
+    // not finite altitude stays in table
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    EXPECT_DOUBLE_EQ(atmosphere.density(nan), atmosphere.density(def::ATMOSPHERE_MIN_ALTITUDE));
+    double density;
+    atmosphere.densities(&nan, &density, 1);
+    EXPECT_DOUBLE_EQ(density, atmosphere.density(def::ATMOSPHERE_MIN_ALTITUDE));
+}
+
+/// Batch lookup should give the same densities as single lookups
+TEST(AtmosphereTest, BatchMatchesSingle) {
+    Atmosphere atmosphere("ISA");
+    std::vector<double> altitude, rho(1000);
+    for (int i = 0; i < 1000; i++)
+    {
+        altitude.push_back(-2000.0 + 97.1*i);
+    }
+    atmosphere.densities(altitude.data(), rho.data(), 1000);
+    for (int i = 0; i < 1000; i++)
+    {
+        EXPECT_DOUBLE_EQ(rho[i], atmosphere.density(altitude[i])) << altitude[i];
+    }
+}
+
+/// Constant model should keep previous sea level density
+TEST(AtmosphereTest, ConstantAndUnknownModels) {
+    Atmosphere constant("constant");
+    EXPECT_TRUE(constant.valid());
+    EXPECT_TRUE(constant.constant());
+    EXPECT_DOUBLE_EQ(constant.density(0.0), def::DEFAULT_AIR_DENSITY);
+    EXPECT_DOUBLE_EQ(constant.density(30000.0), def::DEFAULT_AIR_DENSITY);
+    EXPECT_FALSE(Atmosphere("MARS").valid());
+    Params params{};
+    params.ATMOSPHERE = "MARS";
+    Engine engine(params);
+    EXPECT_FALSE(engine.valid());
+}
+
+/// Vertical speed after falling from given altitude
+static double fallSpeed(Params& params, double altitude)
+{
+    Engine engine(params);
+    int id = engine.addObj(1.0, 0.1, Eigen::Vector3d(0.0,0.0,-altitude), Eigen::Vector3d::Zero());
+    for (int i = 0; i < 4000; i++)
+    {
+        engine.step();
+    }
+    return engine.getState().getVel(engine.getState().findIndex(id)).z();
+}
+
+/// In thin air object should fall faster than with sea level density, with every integrator
+TEST(AtmosphereTest, EngineDragThinsWithAltitude) {
+    Params params{};
+    for(const char* method: {"RK4", "DOPRI5"})
+    {
+        params.ODE_METHOD = method;
+        params.ATMOSPHERE = "constant";
+        const double sea = fallSpeed(params, 20000.0);
+        params.ATMOSPHERE = "ISA";
+        const double thin = fallSpeed(params, 20000.0);
+        // terminal speed scales with 1/sqrt(density), about 3.7 times higher at 20 km
+        EXPECT_GT(thin, 2.5*sea) << method;
+        // ISA density at sea level is close to default one
+        params.ATMOSPHERE = "constant";
+        const double low = fallSpeed(params, 100.0);
+        params.ATMOSPHERE = "ISA";
+        EXPECT_NEAR(fallSpeed(params, 100.0), low, 0.01*low) << method;
+    }
+}
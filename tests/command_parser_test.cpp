@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+#include "command_parser.hpp"
+
+/// Single messages should produce commands and replies used by control socket
+TEST(CommandParserTest, ParsesSingleMessages) {
+    std::vector<cmd::Command> batch;
+    std::string reply = cmd::parse("a:1.0,0.01,1.0,2.0,3.0",batch);
+    ASSERT_EQ(batch.size(), 1u);
+    const auto& add = std::get<cmd::Add>(batch[0]);
+    EXPECT_EQ(reply, "ok;" + std::to_string(add.id));
+    EXPECT_EQ(add.vel, Eigen::Vector3d::Zero());
+    EXPECT_EQ(cmd::parse("w:1,1.0,2.0,3.0;2,0.0,0.0,1.0",batch), "ok");
+    EXPECT_EQ(cmd::parse("f:1,2.0,1.0,0.0",batch), "ok");
+    EXPECT_EQ(cmd::parse("j:1,0.5,0.4,0.3,0.0,0.0,1.0",batch), "ok");
+    EXPECT_EQ(cmd::parse("r:1",batch), "ok");
+    EXPECT_EQ(batch.size(), 6u);
+    EXPECT_EQ(cmd::parse("w:1,1.0,2.0,3.0;2",batch), "ok");
+    ASSERT_EQ(batch.size(), 8u);
+    EXPECT_FALSE(std::get<cmd::Wind>(batch[6]).field);
+    EXPECT_TRUE(std::get<cmd::Wind>(batch[7]).field);
+    EXPECT_EQ(std::get<cmd::Wind>(batch[7]).id, 2);
+}
+
+/// Whitespace around fields and empty tail of wind message should be accepted
+TEST(CommandParserTest, AcceptsWhitespaceAndTrailingSeparator) {
+    std::vector<cmd::Command> batch;
+    ASSERT_EQ(cmd::parse("a:5.0,0.0 ,0.0,0.0,0.0",batch).substr(0,3), "ok;");
+    ASSERT_EQ(cmd::parse("a: 5.0,\t0.0,1.0 , 2.0,3.0\r",batch).substr(0,3), "ok;");
+    ASSERT_EQ(batch.size(), 2u);
+    EXPECT_EQ(std::get<cmd::Add>(batch[1]).pos, Eigen::Vector3d(1.0,2.0,3.0));
+    EXPECT_EQ(cmd::parse("w:1,0,0,0;",batch), "ok");
+    EXPECT_EQ(cmd::parse("w:1,0,0,0;2,1,1,1; ",batch), "ok");
+    ASSERT_EQ(batch.size(), 5u);
+    EXPECT_EQ(std::get<cmd::Wind>(batch[4]).id, 2);
+    // whitespace inside field and empty items in the middle are still invalid
+    EXPECT_EQ(cmd::parse("a:5.0,0.0,1 0,0.0,0.0",batch), "error;number");
+    EXPECT_EQ(cmd::parse("a:5.0, ,0.0,0.0,0.0",batch), "error;number");
+    EXPECT_EQ(cmd::parse("w:1,0,0,0;;2,0,0,0",batch), "error;number");
+    EXPECT_EQ(cmd::parse("w:;",batch), "error;number");
+    EXPECT_EQ(batch.size(), 5u);
+}
+
+/// Invalid messages should not add any command
+TEST(CommandParserTest, RejectsInvalidMessages) {
+    std::vector<cmd::Command> batch;
+    EXPECT_EQ(cmd::parse("a:1.0,0.01,1.0,2.0,",batch), "error;number");
+    EXPECT_EQ(cmd::parse("a:1.0,0.01,1.0,2.0,0.0,0.0",batch), "error;missing");
+    EXPECT_EQ(cmd::parse("a:1.0,0.01,1.0,2.0,0.0,0.0,0.0,0.0,0.0",batch), "error;extra");
+    EXPECT_EQ(cmd::parse("a:0.0,0.01,1.0,2.0,0.0",batch), "error;range");
+    EXPECT_EQ(cmd::parse("w:1,1.0,2.0,3.0;2,0.0",batch), "error;missing");
+    EXPECT_EQ(cmd::parse("w:1,nan,2.0,3.0",batch), "error;range");
+    EXPECT_EQ(cmd::parse("f:1,x,1.0,0.0",batch), "error;number");
+    EXPECT_EQ(cmd::parse("f:1,1.0x,1.0,0.0",batch), "error;number");
+    EXPECT_EQ(cmd::parse("f:-1,1.0,1.0,0.0",batch), "error;range");
+    EXPECT_EQ(cmd::parse("r:-1",batch), "error;range");
+    EXPECT_EQ(cmd::parse("w:-1",batch), "error;range");
+    EXPECT_EQ(cmd::parse("w:1,2.0",batch), "error;missing");
+    EXPECT_EQ(cmd::parse("w:1,1.0,2.0,3.0;-2,0.0,0.0,1.0",batch), "error;range");
+    EXPECT_EQ(cmd::parse("j:-1,0.5,0.4,0.3,0.0,0.0,1.0",batch), "error;range");
+    EXPECT_EQ(cmd::parse("r:99999999999999999999",batch), "error;range");
+    EXPECT_EQ(cmd::parse("r:",batch), "error;number");
+    EXPECT_EQ(cmd::parse("j:1,0.5,0.3,0.4,0.0,0.0,1.0",batch), "error;range");
+    EXPECT_EQ(cmd::parse("s:",batch), "error;command");
+    EXPECT_EQ(cmd::parse("",batch), "error;command");
+    EXPECT_TRUE(batch.empty());
+}
+
+/// Batch should reply per item and keep items only if all of them are valid
+TEST(CommandParserTest, ParsesBatch) {
+    std::vector<cmd::Command> batch;
+    std::string reply = cmd::parseBatch("b:a:5.0,0.0,0.0,0.0,0.0\na:5.0,0.0,1.0,0.0,0.0\nr:3",batch);
+    ASSERT_EQ(batch.size(), 3u);
+    const int first = std::get<cmd::Add>(batch[0]).id;
+    const int second = std::get<cmd::Add>(batch[1]).id;
+    EXPECT_EQ(reply, "ok\nok;" + std::to_string(first) + "\nok;" + std::to_string(second) + "\nok");
+    // rejected batch does not report ids of objects that are not added
+    reply = cmd::parseBatch("b:r:1\nf:7,1.0\na:5.0,0.0,2.0,0.0,0.0",batch);
+    EXPECT_EQ(reply, "error\nskipped\nerror;missing\nskipped");
+    EXPECT_EQ(batch.size(), 3u);
+    EXPECT_EQ(cmd::parseBatch("bx:r:1",batch), "error;command");
+    EXPECT_EQ(cmd::parseBatch("b",batch), "error;command");
+    EXPECT_EQ(batch.size(), 3u);
+}
+
+/// Impact query should accept optional ground level
+TEST(CommandParserTest, ParsesImpactQuery) {
+    int id;
+    double groundZ;
+    EXPECT_TRUE(cmd::parseImpactQuery("p:4",id,groundZ));
+    EXPECT_EQ(id, 4);
+    EXPECT_EQ(groundZ, 0.0);
+    EXPECT_TRUE(cmd::parseImpactQuery("p:5,-12.5",id,groundZ));
+    EXPECT_EQ(id, 5);
+    EXPECT_EQ(groundZ, -12.5);
+    EXPECT_FALSE(cmd::parseImpactQuery("p:5,1.0,2.0",id,groundZ));
+    EXPECT_FALSE(cmd::parseImpactQuery("p:-1",id,groundZ));
+    EXPECT_FALSE(cmd::parseImpactQuery("p:x",id,groundZ));
+}
+
+/// Allocation counter of tick tests, defined in engine_test.cpp
+namespace alloc_hook
+{
+    extern thread_local bool enabled;
+    extern thread_local int count;
+}
+
+/// Parsing stream of wind and force messages should not touch heap
+TEST(CommandParserTest, ParsingDoesNotAllocate) {
+    std::vector<cmd::Command> batch;
+    batch.reserve(16);
+    const std::string wind = "w:12,1.5,-2.25,0.0;13,3.0,4.0,5.0";
+    const std::string force = "f:12,10.0,0.5,-3.0";
+    const std::string invalid = "f:12,10.0,0.5";
+    alloc_hook::count = 0;
+    alloc_hook::enabled = true;
+    for (int i = 0; i < 100; i++)
+    {
+        cmd::parseCommand(wind,batch);
+        cmd::parseCommand(force,batch);
+        cmd::parseCommand(invalid,batch);
+        batch.clear();
+    }
+    alloc_hook::enabled = false;
+    EXPECT_EQ(alloc_hook::count, 0);
+}
+
+/// Random and mutated messages should never throw and should add commands only when accepted
+TEST(CommandParserTest, Fuzz) {
+    const std::vector<std::string> seeds = {
+        "a:1.0,0.01,1.0,2.0,3.0,4.0,5.0,6.0", "r:7", "w:1,1.0,2.0,3.0;2,0.0,0.0,1.0",
+        "f:1,2.0,1.0,0.0", "j:1,0.5,0.4,0.3,0.0,0.0,1.0", "p:3,-1.5"};
+    const std::string alphabet = "0123456789.,;:-+eEnaifrwjxp \n";
+    std::mt19937 gen(2024);
+    std::vector<cmd::Command> batch;
+    for (int i = 0; i < 200000; i++)
+    {
+        std::string msg = seeds[gen() % seeds.size()];
+        const int mutations = 1 + gen() % 4;
+        for (int m = 0; m < mutations; m++)
+        {
+            const size_t pos = msg.empty() ? 0 : gen() % msg.size();
+            switch(gen() % 4)
+            {
+                case 0:
+                    if(!msg.empty()) msg.erase(pos,1);
+                    break;
+                case 1:
+                    msg.insert(msg.begin() + pos, alphabet[gen() % alphabet.size()]);
+                    break;
+                case 2:
+                    if(!msg.empty()) msg[pos] = static_cast<char>(gen());
+                    break;
+                case 3:
+                    msg = msg.substr(0,pos);
+                    break;
+            }
+        }
+        const size_t before = batch.size();
+        cmd::Error error = cmd::Error::none;
+        ASSERT_NO_THROW(error = cmd::parseCommand(msg,batch)) << msg;
+        if(error != cmd::Error::none)
+        {
+            ASSERT_EQ(batch.size(), before) << msg;
+        }
+        else
+        {
+            ASSERT_GT(batch.size(), before) << msg;
+        }
+        int id;
+        double groundZ;
+        ASSERT_NO_THROW(cmd::parseImpactQuery(msg,id,groundZ)) << msg;
+        if(batch.size() > 1000) batch.clear();
+    }
+}
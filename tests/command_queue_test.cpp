@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include <Eigen/Dense>
+#include <thread>
+#include <vector>
+#include "command_queue.hpp"
+#include "engine.hpp"
+#include "params.hpp"
+
+/// Commands of every producer should be drained in push order, none lost
+TEST(CommandQueueTest, ManyProducersKeepOrder) {
+    CommandQueue queue;
+    const int producers = 4, perProducer = 10000;
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++)
+    {
+        threads.emplace_back([&queue,p]()
+        {
+            for (int i = 0; i < perProducer; i++)
+            {
+                queue.push(cmd::Remove{p*perProducer + i});
+            }
+        });
+    }
+    std::vector<int> last(producers,-1);
+    int drained = 0;
+    auto check = [&](const cmd::Command& command)
+    {
+        int id = std::get<cmd::Remove>(command).id;
+        EXPECT_GT(id % perProducer, last[id / perProducer]);
+        last[id / perProducer] = id % perProducer;
+    };
+    while(drained < producers*perProducer)
+    {
+        drained += queue.drain(check);
+    }
+    for(auto& t: threads) t.join();
+    EXPECT_EQ(queue.drain(check), 0);
+}
+
+/// Batch should be drained as a whole
+TEST(CommandQueueTest, BatchDrainedTogether) {
+    CommandQueue queue;
+    std::vector<cmd::Command> batch;
+    for (int i = 0; i < 5; i++)
+    {
+        batch.push_back(cmd::Wind{i,Eigen::Vector3d(i,0.0,0.0)});
+    }
+    queue.push(std::move(batch));
+    queue.push(cmd::Remove{7});
+    int wind = 0;
+    EXPECT_EQ(queue.drain([&wind](const cmd::Command& command)
+    {
+        if(std::holds_alternative<cmd::Wind>(command)) wind++;
+    }), 6);
+    EXPECT_EQ(wind, 5);
+}
+
+/// Copied batches should keep order and content while producer reuses its buffer and nodes are recycled
+TEST(CommandQueueTest, CopiedBatchesReuseBuffers) {
+    CommandQueue queue;
+    std::vector<cmd::Command> batch;
+    batch.reserve(4);
+    for (int round = 0; round < 100; round++)
+    {
+        for (int k = 0; k < 1 + round % 3; k++)
+        {
+            batch.clear();
+            for (int i = 0; i < 4; i++)
+            {
+                batch.push_back(cmd::Remove{round*100 + k*10 + i});
+            }
+            queue.push(batch);
+            EXPECT_EQ(batch.size(), 4u);
+        }
+        int drained = 0;
+        queue.drain([&](const cmd::Command& command)
+        {
+            const int id = std::get<cmd::Remove>(command).id;
+            EXPECT_EQ(id, round*100 + (drained/4)*10 + drained%4);
+            drained++;
+        });
+        EXPECT_EQ(drained, 4*(1 + round % 3));
+    }
+}
+
+/// Object added by command should get id reserved by producer
+TEST(CommandQueueTest, AppliedAddUsesReservedId) {
+    Params params{};
+    Engine engine(params);
+    CommandQueue queue;
+    int id = ObjParams::nextId();
+    queue.push(cmd::Add{id,1.0,0.1,Eigen::Vector3d(1.0,2.0,3.0),Eigen::Vector3d(0.0,0.0,0.0)});
+    queue.push(cmd::Wind{id,Eigen::Vector3d(4.0,0.0,0.0)});
+    queue.drain([&engine](const cmd::Command& command) {engine.apply(command);});
+    State& state = engine.getState();
+    int index = state.findIndex(id);
+    ASSERT_GE(index, 0);
+    EXPECT_EQ(state.getPos(index), Eigen::Vector3d(1.0,2.0,3.0));
+    EXPECT_EQ(state.getParams(index)->getWind(), Eigen::Vector3d(4.0,0.0,0.0));
+    queue.push(cmd::Remove{id});
+    queue.drain([&engine](const cmd::Command& command) {engine.apply(command);});
+    EXPECT_EQ(state.findIndex(id), -1);
+}
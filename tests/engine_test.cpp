@@ -0,0 +1,271 @@
+#include <gtest/gtest.h>
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include "engine.hpp"
+#include "params.hpp"
+#include "defines.hpp"
+
+/// Allocation counting hook. Every operator new on thread with counting enabled is counted.
+/// Background threads (e.g. log writer) are not part of tick and are not counted
+namespace alloc_hook
+{
+    thread_local bool enabled = false;
+    thread_local int count = 0;
+
+    void* allocate(std::size_t size)
+    {
+        if(enabled) count++;
+        void* ptr = std::malloc(size == 0 ? 1 : size);
+        if(ptr == nullptr) throw std::bad_alloc();
+        return ptr;
+    }
+}
+
+void* operator new(std::size_t size) { return alloc_hook::allocate(size); }
+void* operator new[](std::size_t size) { return alloc_hook::allocate(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+/// Count allocations made by given number of ticks
+int allocationsPerTicks(Engine& engine, int ticks)
+{
+    alloc_hook::count = 0;
+    alloc_hook::enabled = true;
+    for (int i = 0; i < ticks; i++)
+    {
+        engine.step();
+    }
+    alloc_hook::enabled = false;
+    return alloc_hook::count;
+}
+
+/// Steady state tick should not touch heap
+TEST(EngineTest, SteadyStateTickDoesNotAllocate) {
+    Params params{};
+    Engine engine(params);
+    ASSERT_TRUE(engine.valid());
+    for (int i = 0; i < 100; i++)
+    {
+        engine.addObj(1.0 + i, 0.01*i, Eigen::Vector3d(i,0.0,0.0), Eigen::Vector3d(0.0,1.0,0.0));
+    }
+    engine.getState().updateWind(3,Eigen::Vector3d(5.0,0.0,0.0));
+    engine.step();
+    EXPECT_EQ(allocationsPerTicks(engine, 100), 0);
+}
+
+/// Removing objects should not cause allocation in next ticks
+TEST(EngineTest, TickAfterRemovalDoesNotAllocate) {
+    Params params{};
+    Engine engine(params);
+    int first = engine.addObj(1.0, 0.0, Eigen::Vector3d(0.0,0.0,0.0));
+    for (int i = 0; i < 10; i++)
+    {
+        engine.addObj(1.0, 0.1, Eigen::Vector3d(i,0.0,0.0));
+    }
+    engine.step();
+    engine.removeObj(first);
+    EXPECT_EQ(allocationsPerTicks(engine, 10), 0);
+    EXPECT_EQ(engine.getState().getNoObj(), 10);
+}
+
+/// In place integration should reproduce free fall
+TEST(EngineTest, FreeFall) {
+    Params params{};
+    Engine engine(params);
+    int id = engine.addObj(1.0, 0.0, Eigen::Vector3d(1.0,2.0,3.0));
+    const int steps = 1000;
+    for (int i = 0; i < steps; i++)
+    {
+        engine.step();
+    }
+    State& state = engine.getState();
+    const double t = steps*params.STEP_TIME;
+    int index = state.findIndex(id);
+    EXPECT_NEAR(state.getPos(index).z(), 3.0 + 0.5*def::GRAVITY_CONST*t*t, 1e-9);
+    EXPECT_NEAR(state.getVel(index).z(), def::GRAVITY_CONST*t, 1e-9);
+    EXPECT_NEAR(state.real_time, t, 1e-9);
+}
+
+/// Outer force should act for def::VALIDITY_OF_FORCE whole steps, independent of ODE stages
+TEST(EngineTest, ForceValidityCountedInSteps) {
+    Params params{};
+    Engine engine(params);
+    State& state = engine.getState();
+    int id = engine.addObj(2.0, 0.0, Eigen::Vector3d(0.0,0.0,0.0));
+    state.updateForce(id,Eigen::Vector3d(0.0,0.0,-2.0*def::GRAVITY_CONST));
+    for (int i = 0; i < def::VALIDITY_OF_FORCE; i++)
+    {
+        engine.step();
+    }
+    int index = state.findIndex(id);
+    EXPECT_NEAR(state.getVel(index).z(), 0.0, 1e-12);
+    engine.step();
+    EXPECT_NEAR(state.getVel(index).z(), def::GRAVITY_CONST*params.STEP_TIME, 1e-12);
+}
+
+/// Adaptive integrator should match fixed step RK4 with fewer RHS evaluations
+TEST(EngineTest, AdaptiveMatchesRK4) {
+    Params params{};
+    Engine rk4(params);
+    params.ODE_METHOD = "DOPRI5";
+    Engine dopri(params);
+    ASSERT_TRUE(dopri.valid());
+    for(Engine* engine: {&rk4, &dopri})
+    {
+        engine->addObj(2.0, 0.01, Eigen::Vector3d(0.0,0.0,-500.0), Eigen::Vector3d(30.0,0.0,-5.0));
+        engine->getState().updateWind(engine->getState().getParams(0)->id, Eigen::Vector3d(0.0,4.0,0.0));
+    }
+    const int steps = 2000;
+    for (int i = 0; i < steps; i++)
+    {
+        rk4.step();
+        dopri.step();
+    }
+    for (int j = 0; j < 6; j++)
+    {
+        EXPECT_NEAR(dopri.getState().getState()(j), rk4.getState().getState()(j), 1e-4) << "coordinate " << j;
+    }
+    EXPECT_LT(dopri.getAdaptiveIntegrator().getEvaluations(), steps);
+}
+
+/// Not finite force should not make adaptive integrator shrink step forever
+TEST(EngineTest, AdaptiveFinishesWithNotFiniteForce) {
+    Params params{};
+    params.ODE_METHOD = "DOPRI5";
+    params.ATMOSPHERE = "ISA";
+    Engine engine(params);
+    ASSERT_TRUE(engine.valid());
+    int nan = engine.addObj(1.0, 0.01, Eigen::Vector3d(0.0,0.0,-100.0));
+    int inf = engine.addObj(1.0, 0.01, Eigen::Vector3d(0.0,0.0,-100.0));
+    int fine = engine.addObj(1.0, 0.01, Eigen::Vector3d(0.0,0.0,-100.0));
+    engine.apply(cmd::Force{nan, Eigen::Vector3d(std::numeric_limits<double>::quiet_NaN(),0.0,0.0)});
+    engine.apply(cmd::Force{inf, Eigen::Vector3d(0.0,std::numeric_limits<double>::infinity(),0.0)});
+    for (int i = 0; i < 10; i++)
+    {
+        engine.step();
+    }
+    const AdaptiveIntegrator& adaptive = engine.getAdaptiveIntegrator();
+    EXPECT_GT(adaptive.getForcedSteps(), 0);
+    EXPECT_LT(adaptive.getEvaluations(), 1000);
+    State& state = engine.getState();
+    EXPECT_TRUE(state.getPos(state.findIndex(fine)).allFinite());
+}
+
+/// Object kept on surface by collisions should fall asleep, stay in place and wake on outer force
+TEST(EngineTest, RestingObjectSleepsAndWakes) {
+    Params params{};
+    Engine engine(params);
+    State& state = engine.getState();
+    int resting = engine.addObj(1.0, 0.0, Eigen::Vector3d(0.0,0.0,0.0));
+    engine.addObj(1.0, 0.0, Eigen::Vector3d(5.0,0.0,-100.0));
+    const Eigen::Vector3d up(0.0,0.0,-1.0);
+    int disturbed = 0;
+    for (int i = 0; i < def::SLEEP_STEPS + 10; i++)
+    {
+        engine.calcImpulseForce(resting, 0.0, 0.0, 0.0, up);
+        engine.step();
+        disturbed += std::count(engine.getDisturbed().begin(), engine.getDisturbed().end(), resting);
+    }
+    engine.step();
+    int index = state.findIndex(resting);
+    ASSERT_TRUE(state.getParams(index)->asleep);
+    // falling asleep zeroes velocity, so it is reported once
+    EXPECT_EQ(disturbed, 1);
+    EXPECT_EQ(state.getNoAwake(), 1);
+    const Eigen::Vector3d pos = state.getPos(index);
+    for (int i = 0; i < 10; i++)
+    {
+        engine.step();
+    }
+    index = state.findIndex(resting);
+    EXPECT_EQ(state.getPos(index), pos);
+
+    state.updateForce(resting, Eigen::Vector3d(10.0,0.0,0.0));
+    engine.step();
+    index = state.findIndex(resting);
+    EXPECT_FALSE(state.getParams(index)->asleep);
+    EXPECT_EQ(state.getNoAwake(), 2);
+    EXPECT_GT(state.getPos(index).x(), 0.0);
+}
+
+/// Object asleep under wind field should wake on wind override, also when override is zero
+TEST(EngineTest, WindOverrideWakesObjectFollowingField) {
+    Params params{};
+    Engine engine(params);
+    State& state = engine.getState();
+    int resting = engine.addObj(1.0, 0.0, Eigen::Vector3d(0.0,0.0,0.0));
+    for (int i = 0; i < def::SLEEP_STEPS + 10; i++)
+    {
+        engine.calcImpulseForce(resting, 0.0, 0.0, 0.0, Eigen::Vector3d(0.0,0.0,-1.0));
+        engine.step();
+    }
+    ASSERT_TRUE(state.getParams(state.findIndex(resting))->asleep);
+    ASSERT_FALSE(state.getParams(state.findIndex(resting))->hasWind());
+    engine.apply(cmd::Wind{resting, Eigen::Vector3d::Zero()});
+    EXPECT_FALSE(state.getParams(state.findIndex(resting))->asleep);
+    EXPECT_TRUE(state.getParams(state.findIndex(resting))->hasWind());
+
+    // repeated override does not change effective wind
+    for (int i = 0; i < def::SLEEP_STEPS + 10; i++)
+    {
+        engine.calcImpulseForce(resting, 0.0, 0.0, 0.0, Eigen::Vector3d(0.0,0.0,-1.0));
+        engine.step();
+    }
+    ASSERT_TRUE(state.getParams(state.findIndex(resting))->asleep);
+    engine.apply(cmd::Wind{resting, Eigen::Vector3d::Zero()});
+    EXPECT_TRUE(state.getParams(state.findIndex(resting))->asleep);
+}
+
+/// Moved object params should keep sleep state and wind override
+TEST(EngineTest, ObjParamsMoveKeepsAllFields) {
+    ObjParams params(1.0, 0.1);
+    params.asleep = true;
+    params.slowSteps = 3;
+    params.asleepSince = 42;
+    params.setWind(Eigen::Vector3d(1.0,2.0,3.0));
+    ObjParams moved(std::move(params));
+    EXPECT_TRUE(moved.asleep);
+    EXPECT_EQ(moved.slowSteps, 3);
+    EXPECT_EQ(moved.asleepSince, 42u);
+    EXPECT_TRUE(moved.hasWind());
+    EXPECT_EQ(moved.getWind(), Eigen::Vector3d(1.0,2.0,3.0));
+}
+
+/// Parallel integration of large swarm should give the same bits as single thread and should not allocate
+TEST(EngineTest, ParallelStepIsBitIdentical) {
+    Params params{};
+    params.THREADS = 1;
+    Engine serial(params);
+    params.THREADS = 4;
+    Engine parallel(params);
+    const int no = 4*def::PARALLEL_CHUNK + 37;
+    ASSERT_GE(no, def::PARALLEL_MIN_OBJECTS);
+    for(Engine* engine: {&serial, &parallel})
+    {
+        for (int i = 0; i < no; i++)
+        {
+            int id = engine->addObj(1.0 + 0.01*i, 0.001*(i%50), Eigen::Vector3d(i,0.0,-1000.0),
+                Eigen::Vector3d(0.1*(i%7),0.2*(i%3),-1.0));
+            engine->getState().updateWind(id,Eigen::Vector3d(0.5*(i%11),-1.0,0.0));
+        }
+    }
+    parallel.step();
+    serial.step();
+    EXPECT_EQ(allocationsPerTicks(parallel, 50), 0);
+    for (int i = 0; i < 50; i++)
+    {
+        serial.step();
+    }
+    const Eigen::VectorXd& a = serial.getState().getState();
+    const Eigen::VectorXd& b = parallel.getState().getState();
+    ASSERT_EQ(a.size(), b.size());
+    for (int i = 0; i < a.size(); i++)
+    {
+        ASSERT_EQ(a(i), b(i)) << "coordinate " << i;
+    }
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <sstream>
+#include "ensemble.hpp"
+#include "params.hpp"
+#include "defines.hpp"
+
+/// Without perturbations every realization should land in the same point
+TEST(EnsembleTest, NoPerturbationGivesSinglePoint) {
+    Params params{};
+    ensemble::Config config;
+    config.count = 300;
+    config.CS = 0.0;
+    config.pos = Eigen::Vector3d(10.0,-5.0,-100.0);
+    config.vel = Eigen::Vector3d(2.0,0.0,0.0);
+    ensemble::Result result;
+    ASSERT_TRUE(ensemble::run(config, params, result));
+    ASSERT_EQ(result.impacted, 300);
+    const double tof = std::sqrt(2.0*100.0/def::GRAVITY_CONST);
+    EXPECT_NEAR(result.tofMean, tof, 1e-3);
+    EXPECT_NEAR(result.meanImpact.x(), 10.0 + 2.0*tof, 1e-2);
+    EXPECT_NEAR(result.meanImpact.y(), -5.0, 1e-9);
+    EXPECT_NEAR(result.CEP, 0.0, 1e-9);
+    EXPECT_EQ(result.tofHistogram[0], 300);
+}
+
+/// Same seed should give identical statistics for any number of threads
+TEST(EnsembleTest, ReproducibleAcrossThreadCounts) {
+    Params params{};
+    ensemble::Config config;
+    config.count = 1000;
+    config.seed = 7;
+    config.pos = Eigen::Vector3d(0.0,0.0,-200.0);
+    config.sigmaMass = 0.1;
+    config.sigmaCS = 0.002;
+    config.sigmaVel = Eigen::Vector3d(1.0,1.0,0.5);
+    config.sigmaWind = Eigen::Vector3d(2.0,2.0,0.0);
+    config.threads = 1;
+    ensemble::Result single, multi;
+    ASSERT_TRUE(ensemble::run(config, params, single));
+    config.threads = 4;
+    ASSERT_TRUE(ensemble::run(config, params, multi));
+    ASSERT_EQ(single.impacted, multi.impacted);
+    EXPECT_EQ(single.meanImpact, multi.meanImpact);
+    EXPECT_EQ(single.covariance, multi.covariance);
+    EXPECT_EQ(single.CEP, multi.CEP);
+    EXPECT_EQ(single.tofHistogram, multi.tofHistogram);
+    EXPECT_GT(single.CEP, 0.0);
+    EXPECT_GE(single.semiMajor, single.semiMinor);
+}
+
+/// Config file keys should map to fields
+TEST(EnsembleTest, LoadsConfig) {
+    ensemble::Config config;
+    std::istringstream in("# drop\ncount=50\nseed=3\nmass=2.5\npos=1,2,-300\nsigmaWind=1,1,0\n");
+    ASSERT_TRUE(config.load(in));
+    EXPECT_EQ(config.count, 50);
+    EXPECT_EQ(config.seed, 3u);
+    EXPECT_EQ(config.mass, 2.5);
+    EXPECT_EQ(config.pos, Eigen::Vector3d(1.0,2.0,-300.0));
+    EXPECT_EQ(config.sigmaWind, Eigen::Vector3d(1.0,1.0,0.0));
+    std::istringstream bad("speed=3\n");
+    EXPECT_FALSE(config.load(bad));
+}
+
+/// Out of range values should be rejected
+TEST(EnsembleTest, RejectsInvalidConfig) {
+    for(const char* line: {"count=-5", "count=0", "histogramBins=0", "maxTime=0", "maxTime=-1", "threads=-1",
+        "mass=0", "sigmaCS=-0.1", "sigmaPos=0,-1,0"})
+    {
+        ensemble::Config config;
+        std::istringstream in(line);
+        EXPECT_FALSE(config.load(in)) << line;
+    }
+}
+
+/// Unsupported ODE method or atmosphere should fail instead of giving empty statistics
+TEST(EnsembleTest, RejectsUnsupportedParams) {
+    ensemble::Config config;
+    config.count = 10;
+    ensemble::Result result;
+    {
+        Params params{};
+        params.ODE_METHOD = "unknown";
+        EXPECT_FALSE(ensemble::run(config, params, result));
+    }
+    {
+        Params params{};
+        params.ATMOSPHERE = "unknown";
+        EXPECT_FALSE(ensemble::run(config, params, result));
+    }
+    EXPECT_EQ(result.count, 0);
+}
+
+/// Realizations released at different heights should keep own impact time after others land
+TEST(EnsembleTest, LandedRealizationsLeaveBatch) {
+    Params params{};
+    ensemble::Config config;
+    config.count = 64;
+    config.CS = 0.0;
+    config.pos = Eigen::Vector3d(0.0,0.0,-100.0);
+    config.sigmaPos = Eigen::Vector3d(0.0,0.0,40.0);
+    config.vel = Eigen::Vector3d(1.0,0.0,0.0);
+    ensemble::Result result;
+    ASSERT_TRUE(ensemble::run(config, params, result));
+    ASSERT_EQ(result.impacted, 64);
+    // without drag impact x equals time of flight, so swapping landed realizations out must keep both together
+    EXPECT_GT(result.tofMax - result.tofMin, 1.0);
+    for(const auto& impact: result.impacts)
+    {
+        EXPECT_GE(impact.x(), result.tofMin - 1e-9);
+        EXPECT_LE(impact.x(), result.tofMax + 1e-9);
+        EXPECT_NEAR(impact.y(), 0.0, 1e-12);
+    }
+    EXPECT_NEAR(result.tofMean, result.meanImpact.x(), 1e-9);
+}
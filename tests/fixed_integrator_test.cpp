@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+#include <Eigen/Dense>
+#include <string>
+#include "fixed_integrator.hpp"
+#include "engine.hpp"
+#include "params.hpp"
+#include "defines.hpp"
+
+/// Every fixed step method should follow trajectory of engine integrated with the same method
+TEST(FixedIntegratorTest, MatchesEngine) {
+    for(std::string name: {"Euler", "Midpoint", "Heun", "Ralston", "RK3", "SSPRK3", "RK4", "RK38"})
+    {
+        Params params{};
+        params.ODE_METHOD = name;
+        Engine engine(params);
+        const Eigen::Vector3d pos(0.0,0.0,-800.0), vel(25.0,-3.0,-10.0), wind(2.0,6.0,0.5);
+        int id = engine.addObj(1.5, 0.02, pos, vel);
+        engine.getState().updateWind(id,wind);
+
+        auto method = fixed::fromString(name);
+        ASSERT_TRUE(method.has_value()) << name;
+        const fixed::Inputs inputs{wind, Eigen::Vector3d::Zero(), 1.5, 0.02, def::DEFAULT_AIR_DENSITY};
+        fixed::Vector6d y;
+        y << pos, vel;
+        const int steps = 1000;
+        for (int i = 0; i < steps; i++)
+        {
+            engine.step();
+            std::visit([&](const auto& stepper)
+            {
+                stepper(y, params.STEP_TIME, [&](const fixed::Vector6d& s) {return fixed::derivative(s,inputs);});
+            }, *method);
+        }
+        State& state = engine.getState();
+        int index = state.findIndex(id);
+        for (int j = 0; j < 3; j++)
+        {
+            EXPECT_NEAR(y(j), state.getPos(index)(j), 1e-9) << name << " coordinate " << j;
+            EXPECT_NEAR(y(3+j), state.getVel(index)(j), 1e-9) << name << " coordinate " << 3+j;
+        }
+    }
+}
+
+/// Methods without fixed step variant should not be found
+TEST(FixedIntegratorTest, UnknownMethod) {
+    EXPECT_FALSE(fixed::fromString("DOPRI5").has_value());
+    EXPECT_FALSE(fixed::fromString("rk4").has_value());
+    EXPECT_EQ(std::visit([](const auto& stepper) {return stepper.stages;}, *fixed::fromString("RK38")), 4);
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include <Eigen/Dense>
+#include <random>
+#include "force_kernel.hpp"
+#include "defines.hpp"
+
+/// Reference acceleration, formula used before batched kernel
+Eigen::Vector3d referenceAcceleration(Eigen::Vector3d vel, Eigen::Vector3d wind, Eigen::Vector3d force, double mass, double CS)
+{
+    static const Eigen::Vector3d gravity = Eigen::Vector3d(0.0,0.0,def::GRAVITY_CONST);
+    Eigen::Vector3d diff = vel-wind;
+    double dynamic_pressure = 0.5*def::DEFAULT_AIR_DENSITY*diff.dot(diff);
+    Eigen::Vector3d aero(0.0,0.0,0.0);
+    if(dynamic_pressure != 0.0)
+    {
+        aero = -CS*dynamic_pressure*diff.normalized();
+    }
+    return (mass*gravity + aero + force)/mass;
+}
+
+/// Fill batch with random objects. Every fifth object moves with wind
+void randomBatch(kernel::ForceBatch& batch, int n)
+{
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> speed(-50.0,50.0), positive(0.1,10.0);
+    batch.reserve(n);
+    for (int i = 0; i < n; i++)
+    {
+        batch.vx[i] = speed(gen); batch.vy[i] = speed(gen); batch.vz[i] = speed(gen);
+        batch.wx[i] = speed(gen); batch.wy[i] = speed(gen); batch.wz[i] = speed(gen);
+        if(i % 5 == 0)
+        {
+            batch.wx[i] = batch.vx[i]; batch.wy[i] = batch.vy[i]; batch.wz[i] = batch.vz[i];
+        }
+        batch.fx[i] = speed(gen); batch.fy[i] = speed(gen); batch.fz[i] = speed(gen);
+        batch.mass[i] = positive(gen);
+        batch.CS[i] = positive(gen)/10.0;
+    }
+}
+
+void expectMatchesReference(const kernel::ForceBatch& batch, int n)
+{
+    for (int i = 0; i < n; i++)
+    {
+        Eigen::Vector3d expected = referenceAcceleration(
+            {batch.vx[i],batch.vy[i],batch.vz[i]}, {batch.wx[i],batch.wy[i],batch.wz[i]},
+            {batch.fx[i],batch.fy[i],batch.fz[i]}, batch.mass[i], batch.CS[i]);
+        const double tol = 1e-12*std::max(1.0,expected.norm());
+        EXPECT_NEAR(batch.ax[i], expected.x(), tol) << "object " << i;
+        EXPECT_NEAR(batch.ay[i], expected.y(), tol) << "object " << i;
+        EXPECT_NEAR(batch.az[i], expected.z(), tol) << "object " << i;
+    }
+}
+
+/// Scalar kernel should reproduce per object formula
+TEST(ForceKernelTest, ScalarMatchesReference) {
+    const int n = 1001;
+    kernel::ForceBatch batch;
+    randomBatch(batch,n);
+    kernel::accelerationsScalar(batch,n,def::DEFAULT_AIR_DENSITY);
+    expectMatchesReference(batch,n);
+}
+
+/// Vectorized kernel should reproduce per object formula, including tail not divisible by vector width
+TEST(ForceKernelTest, AVX2MatchesReference) {
+    if(!kernel::hasAVX2())
+    {
+        GTEST_SKIP() << "CPU does not support AVX2";
+    }
+    const int n = 1003;
+    kernel::ForceBatch batch;
+    randomBatch(batch,n);
+    kernel::accelerationsAVX2(batch,n,def::DEFAULT_AIR_DENSITY);
+    expectMatchesReference(batch,n);
+}
+
+/// Kernels with density of every object should match constant density kernel and scale drag with density
+TEST(ForceKernelTest, DensityPerObject) {
+    const int n = 1003;
+    kernel::ForceBatch batch;
+    randomBatch(batch,n);
+    for (int i = 0; i < n; i++)
+    {
+        batch.rho[i] = def::DEFAULT_AIR_DENSITY;
+    }
+    kernel::accelerations(batch,0,n);
+    expectMatchesReference(batch,n);
+    for (int i = 0; i < n; i++)
+    {
+        batch.rho[i] = 0.01*(i % 100);
+    }
+    kernel::accelerationsScalar(batch,0,n);
+    for (int i = 0; i < n; i++)
+    {
+        const Eigen::Vector3d expected = kernel::acceleration({batch.vx[i],batch.vy[i],batch.vz[i]},
+            {batch.wx[i],batch.wy[i],batch.wz[i]}, {batch.fx[i],batch.fy[i],batch.fz[i]},
+            batch.mass[i], batch.CS[i], batch.rho[i]);
+        EXPECT_NEAR((Eigen::Vector3d(batch.ax[i],batch.ay[i],batch.az[i]) - expected).norm(), 0.0, 1e-12) << i;
+    }
+    if(kernel::hasAVX2())
+    {
+        std::vector<double> ax = batch.ax;
+        kernel::accelerationsAVX2(batch,0,n);
+        for (int i = 0; i < n; i++)
+        {
+            EXPECT_NEAR(batch.ax[i], ax[i], 1e-12*std::max(1.0,std::abs(ax[i]))) << i;
+        }
+    }
+}
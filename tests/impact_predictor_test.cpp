@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include <Eigen/Dense>
+#include <cmath>
+#include <filesystem>
+#include <future>
+#include <vector>
+#include "impact_predictor.hpp"
+#include "engine.hpp"
+#include "params.hpp"
+#include "defines.hpp"
+
+/// Run query on other thread while this thread plays simulation thread
+ImpactPredictor::Prediction predict(ImpactPredictor& predictor, State& state, int id, double groundZ)
+{
+    auto result = std::async(std::launch::async, [&]()
+    {
+        ImpactPredictor::Prediction prediction;
+        EXPECT_TRUE(predictor.query(id, groundZ, prediction));
+        return prediction;
+    });
+    while(result.wait_for(std::chrono::milliseconds(1)) != std::future_status::ready)
+    {
+        predictor.update(state);
+    }
+    return result.get();
+}
+
+/// Prediction of free fall should match analytic solution and be served from cache
+TEST(ImpactPredictorTest, PredictsFreeFall) {
+    Params params{};
+    State state;
+    Atmosphere atmosphere(params.ATMOSPHERE);
+    WindField noField;
+    ImpactPredictor predictor(params.STEP_TIME, params.ODE_METHOD, atmosphere, noField);
+    int id = state.addObj(1.0, 0.0, Eigen::Vector3d(3.0,0.0,-100.0), Eigen::Vector3d(2.0,0.0,0.0));
+    state.real_time = 1.0;
+    auto prediction = predict(predictor, state, id, 0.0);
+    const double tof = std::sqrt(2.0*100.0/def::GRAVITY_CONST);
+    ASSERT_TRUE(prediction.hit);
+    EXPECT_NEAR(prediction.time, 1.0 + tof, 1e-6);
+    EXPECT_NEAR(prediction.pos.x(), 3.0 + 2.0*tof, 1e-6);
+    EXPECT_NEAR(prediction.pos.z(), 0.0, 1e-9);
+    EXPECT_NEAR(prediction.vel.z(), def::GRAVITY_CONST*tof, 1e-6);
+
+    ImpactPredictor::Prediction cached;
+    EXPECT_TRUE(predictor.query(id, 0.0, cached));
+    EXPECT_EQ(cached.time, prediction.time);
+}
+
+/// Wind change should invalidate cached prediction, unknown object should not hit
+TEST(ImpactPredictorTest, RecomputesAfterWindChange) {
+    Params params{};
+    State state;
+    Atmosphere atmosphere(params.ATMOSPHERE);
+    WindField noField;
+    ImpactPredictor predictor(params.STEP_TIME, params.ODE_METHOD, atmosphere, noField);
+    int id = state.addObj(1.0, 0.05, Eigen::Vector3d(0.0,0.0,-200.0));
+    auto calm = predict(predictor, state, id, 0.0);
+    ASSERT_TRUE(calm.hit);
+    EXPECT_NEAR(calm.pos.y(), 0.0, 1e-9);
+
+    state.updateWind(id, Eigen::Vector3d(0.0,10.0,0.0));
+    predictor.update(state);
+    auto windy = predict(predictor, state, id, 0.0);
+    ASSERT_TRUE(windy.hit);
+    EXPECT_GT(windy.pos.y(), 1.0);
+
+    auto missing = predict(predictor, state, id + 1000, 0.0);
+    EXPECT_FALSE(missing.hit);
+    EXPECT_EQ(predictor.size(), 1u);
+}
+
+/// Invalidated objects should be predicted again from current state, unknown ids ignored
+TEST(ImpactPredictorTest, InvalidatesBatchOfObjects) {
+    Params params{};
+    State state;
+    Atmosphere atmosphere(params.ATMOSPHERE);
+    WindField noField;
+    ImpactPredictor predictor(params.STEP_TIME, params.ODE_METHOD, atmosphere, noField);
+    int id = state.addObj(1.0, 0.0, Eigen::Vector3d(0.0,0.0,-100.0));
+    auto still = predict(predictor, state, id, 0.0);
+    ASSERT_TRUE(still.hit);
+    EXPECT_NEAR(still.pos.x(), 0.0, 1e-9);
+
+    state.setVel(state.findIndex(id), Eigen::Vector3d(5.0,0.0,0.0));
+    predictor.invalidate({id + 1000, id});
+    auto pushed = predict(predictor, state, id, 0.0);
+    ASSERT_TRUE(pushed.hit);
+    EXPECT_GT(pushed.pos.x(), 1.0);
+    EXPECT_EQ(predictor.size(), 1u);
+}
+
+/// Entries of removed objects should be dropped
+TEST(ImpactPredictorTest, ForgetsRemovedObjects) {
+    Params params{};
+    State state;
+    Atmosphere atmosphere(params.ATMOSPHERE);
+    WindField noField;
+    ImpactPredictor predictor(params.STEP_TIME, params.ODE_METHOD, atmosphere, noField);
+    int a = state.addObj(1.0, 0.0, Eigen::Vector3d(0.0,0.0,-10.0));
+    int b = state.addObj(1.0, 0.0, Eigen::Vector3d(0.0,0.0,-20.0));
+    ASSERT_TRUE(predict(predictor, state, a, 0.0).hit);
+    ASSERT_TRUE(predict(predictor, state, b, 0.0).hit);
+    EXPECT_EQ(predictor.size(), 2u);
+    state.removeObj(a);
+    predictor.forget(a);
+    EXPECT_EQ(predictor.size(), 1u);
+    // removed without forget, e.g. by engine
+    state.removeObj(b);
+    predictor.update(state);
+    EXPECT_EQ(predictor.size(), 0u);
+}
+
+/// Prediction should follow live trajectory in wind field and ISA atmosphere
+TEST(ImpactPredictorTest, MatchesEngineWithFieldAndAtmosphere) {
+    WindField::Grid grid;
+    grid.nx = 2;
+    grid.ny = 2;
+    grid.nz = 2;
+    grid.nt = 2;
+    grid.origin = Eigen::Vector3d(-500.0,-500.0,-3000.0);
+    grid.spacing = Eigen::Vector3d(1000.0,1000.0,3000.0);
+    grid.dt = 20.0;
+    std::vector<float> data;
+    for (int t = 0; t < 2; t++)
+        for (int k = 0; k < 2; k++)
+            for (int j = 0; j < 2; j++)
+                for (int i = 0; i < 2; i++)
+                {
+                    data.insert(data.end(), {15.0f - 10.0f*k, 8.0f*t, 0.0f});
+                }
+    Params params{};
+    params.WIND_FIELD = (std::filesystem::temp_directory_path() / "drop_predictor_wind.dwf").string();
+    ASSERT_TRUE(WindField::save(params.WIND_FIELD, grid, data));
+    params.ATMOSPHERE = "ISA";
+    Engine engine(params);
+    ASSERT_TRUE(engine.valid());
+    State& state = engine.getState();
+    ImpactPredictor predictor(params.STEP_TIME, params.ODE_METHOD, engine.getAtmosphere(), engine.getWindField());
+    int id = engine.addObj(1.0, 0.02, Eigen::Vector3d(0.0,0.0,-2000.0), Eigen::Vector3d(30.0,0.0,0.0));
+    auto prediction = predict(predictor, state, id, 0.0);
+    ASSERT_TRUE(prediction.hit);
+    Eigen::Vector3d prev = state.getPos(0);
+    double t = state.real_time;
+    while(state.getPos(0).z() < 0.0)
+    {
+        prev = state.getPos(0);
+        t = state.real_time;
+        engine.step();
+    }
+    const Eigen::Vector3d pos = state.getPos(0);
+    const double frac = -prev.z()/(pos.z() - prev.z());
+    EXPECT_NEAR(prediction.time, t + frac*params.STEP_TIME, 1e-6);
+    EXPECT_NEAR(prediction.pos.x(), prev.x() + frac*(pos.x() - prev.x()), 1e-6);
+    EXPECT_NEAR(prediction.pos.y(), prev.y() + frac*(pos.y() - prev.y()), 1e-6);
+    EXPECT_GT(prediction.pos.y(), 10.0);
+}
@@ -115,6 +115,24 @@ protected:
         }
     }
 
+    /// Send control message and return response
+    std::string requestControl(std::string msg)
+    {
+        zmq::message_t message(msg);
+        if(!controlSocket.send(message, zmq::send_flags::none))
+        {
+            ADD_FAILURE() << "drop can not send message";
+            return "";
+        }
+        zmq::message_t response;
+        if(!controlSocket.recv(response, zmq::recv_flags::none))
+        {
+            ADD_FAILURE() << "drop no response";
+            return "";
+        }
+        return response.to_string();
+    }
+
     int recvState(std::string& response_str)
     {
         zmq::message_t state;
@@ -347,6 +365,30 @@ TEST_F(DropTest, StrongWindInfluence) {
     EXPECT_NEAR(projectiles[1].velocity.y(), 15.0, tol);
 }
 
+/// Test if program applies batch of commands in one message, and nothing of batch with invalid item
+TEST_F(DropTest, BatchCommands) {
+    collectSample();
+    EXPECT_EQ(requestControl("b:a:5.0,0.0,0.0,0.0,0.0\na:5.0,0.0,1.0,0.0,0.0\nw:1,20.0,0.0,0.0\nf:-1,0.0"),
+        "error\nskipped\nskipped\nskipped\nerror;missing");
+    collectSample(3);
+    EXPECT_EQ(getParsedState().second.size(),0);
+    // ids reserved by rejected batch are not reused
+    EXPECT_EQ(requestControl("b:a:5.0,0.0,0.0,0.0,0.0\na:5.0,0.0,1.0,0.0,0.0\nw:3,20.0,0.0,0.0"),
+        "ok\nok;2\nok;3\nok");
+    collectSample(3);
+    auto projectiles = getParsedState().second;
+    EXPECT_EQ(projectiles.size(),2);
+}
+
+/// Test if program reports tick statistics on request
+TEST_F(DropTest, TickStats) {
+    collectSample(10);
+    std::string report = requestControl("t:");
+    EXPECT_EQ(report.rfind("ticks=", 0), 0u);
+    EXPECT_NE(report.find("\nintegration="), std::string::npos);
+    EXPECT_NE(report.find("\ntick="), std::string::npos);
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,43 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include "offline_runner.hpp"
+#include "params.hpp"
+#include "defines.hpp"
+
+/// Scenario should be applied at given times and ended by stop command
+TEST(OfflineRunnerTest, RunsScenario) {
+    Params params{};
+    OfflineRunner runner(params);
+    std::istringstream scenario(
+        "# free fall, second object added later\n"
+        "0.0 a:1.0,0.0,0.0,0.0,0.0\n"
+        "\n"
+        "0.3 a:1.0,0.0,5.0,0.0,0.0\n"
+        "0.6 s:\n");
+    ASSERT_TRUE(runner.load(scenario));
+    std::ostringstream out;
+    ASSERT_TRUE(runner.run(out));
+
+    State& state = runner.getEngine().getState();
+    EXPECT_NEAR(state.real_time, 0.6, 1e-9);
+    ASSERT_EQ(state.getNoObj(), 2);
+    EXPECT_NEAR(state.getPos(0).z(), 0.5*def::GRAVITY_CONST*0.36, 1e-9);
+    EXPECT_NEAR(state.getPos(1).z(), 0.5*def::GRAVITY_CONST*0.09, 1e-9);
+
+    std::istringstream csv(out.str());
+    std::string line;
+    int lines = 0;
+    std::getline(csv, line);
+    EXPECT_EQ(line, "time,id,PosX,PosY,PosZ,VelX,VelY,VelZ");
+    while(std::getline(csv, line)) lines++;
+    EXPECT_EQ(lines, 200 + 100);
+}
+
+/// Invalid command should be reported by load
+TEST(OfflineRunnerTest, RejectsInvalidScenario) {
+    Params params{};
+    OfflineRunner runner(params);
+    std::istringstream scenario("0.0 a:1.0,0.0\n");
+    EXPECT_FALSE(runner.load(scenario));
+}
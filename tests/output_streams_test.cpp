@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include <Eigen/Dense>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "output_streams.hpp"
+#include "state.hpp"
+#include "params.hpp"
+#include "state_frame.hpp"
+
+/// Advance state by one step and count publications of every stream
+/// @param gaps set when any two publications of stream are not exactly its interval apart
+static void run(OutputStreams& streams, State& state, double step, int steps, std::vector<int>& published,
+    std::vector<bool>& gaps)
+{
+    published.assign(streams.size(), 0);
+    gaps.assign(streams.size(), false);
+    std::vector<uint64_t> last(streams.size(), 0);
+    for (int s = 0; s < steps; s++)
+    {
+        streams.update(state);
+        for (size_t i = 0; i < streams.size(); i++)
+        {
+            if(!streams.at(i).due) continue;
+            if(published[i] > 0 && state.tick - last[i] != streams.at(i).interval) gaps[i] = true;
+            last[i] = state.tick;
+            published[i]++;
+        }
+        state.tick++;
+        state.real_time += step;
+    }
+}
+
+/// Streams should keep own rate rounded to whole steps, also when it does not divide step rate
+TEST(OutputStreamsTest, IndependentRates) {
+    Params params{};
+    params.STEP_TIME = 0.003;
+    params.STREAMS = "full:binary:0;ui:text:30;log:text:1;slow:topics:0.5";
+    OutputStreams streams(params);
+    ASSERT_TRUE(streams.valid());
+    ASSERT_EQ(streams.size(), 4u);
+    EXPECT_EQ(streams.at(0).interval, 1u);
+    EXPECT_EQ(streams.at(1).interval, 11u);
+    EXPECT_EQ(streams.at(2).interval, 333u);
+    EXPECT_EQ(streams.at(3).interval, 667u);
+    State state;
+    state.addObj(1.0, 0.1, Eigen::Vector3d(0.0,0.0,-1.0));
+    std::vector<int> published;
+    std::vector<bool> gaps;
+    // 10 s with 3 ms step
+    run(streams, state, params.STEP_TIME, 3334, published, gaps);
+    EXPECT_EQ(published[0], 3334);
+    EXPECT_EQ(published[1], 304);
+    EXPECT_EQ(published[2], 11);
+    EXPECT_EQ(published[3], 5);
+    EXPECT_EQ(gaps, std::vector<bool>(4, false));
+}
+
+/// Rate faster than step rate should publish every step
+TEST(OutputStreamsTest, FastRateEveryStep) {
+    Params params{};
+    params.STEP_TIME = 0.01;
+    params.STREAMS = "fast:text:1000";
+    OutputStreams streams(params);
+    ASSERT_TRUE(streams.valid());
+    EXPECT_EQ(streams.at(0).interval, 1u);
+}
+
+/// Text of streams with same object set should be serialized once, decimated streams include sleeping objects
+TEST(OutputStreamsTest, SharedSerialization) {
+    Params params{};
+    params.STREAMS = "a:text:0;b:text:0;c:text:10;d:binary:10";
+    OutputStreams streams(params);
+    ASSERT_TRUE(streams.valid());
+    State state;
+    int id = state.addObj(1.0, 0.1, Eigen::Vector3d(0.0,0.0,-1.0));
+    ASSERT_EQ(streams.update(state), 4);
+    EXPECT_EQ(&streams.text(0), &streams.text(1));
+    EXPECT_NE(&streams.text(0), &streams.text(2));
+    EXPECT_EQ(streams.text(0), state.to_string());
+    EXPECT_EQ(streams.text(2), state.to_string(true));
+    ASSERT_GE(streams.frame(3).size(), sizeof(drop_frame::Header));
+    drop_frame::Header header;
+    std::memcpy(&header, streams.frame(3).data(), sizeof(header));
+    EXPECT_EQ(header.count, 1u);
+    EXPECT_EQ(streams.text(0).find(std::to_string(id) + ","), 9u);
+
+    // not due streams keep serialization of last publication
+    state.tick = 16;
+    EXPECT_EQ(streams.update(state), 2);
+    EXPECT_FALSE(streams.at(2).due);
+    EXPECT_EQ(streams.text(2).substr(0, 8), "0.000000");
+}
+
+/// Without streams description legacy endpoints should be used
+TEST(OutputStreamsTest, LegacyEndpoints) {
+    Params params{};
+    params.STATE_FORMAT = "both";
+    params.STATE_TOPICS = true;
+    OutputStreams streams(params);
+    ASSERT_TRUE(streams.valid());
+    ASSERT_EQ(streams.size(), 3u);
+    EXPECT_EQ(streams.at(0).name, "state");
+    EXPECT_EQ(streams.at(0).format, OutputStreams::Format::text);
+    EXPECT_EQ(streams.at(1).name, "state_bin");
+    EXPECT_EQ(streams.at(1).format, OutputStreams::Format::binary);
+    EXPECT_EQ(streams.at(2).name, "state_topics");
+    EXPECT_EQ(streams.at(2).format, OutputStreams::Format::topics);
+    EXPECT_EQ(streams.at(2).rate, 0.0);
+}
+
+/// Invalid descriptions should be rejected
+TEST(OutputStreamsTest, InvalidStreams) {
+    std::vector<OutputStreams::Stream> streams;
+    EXPECT_TRUE(OutputStreams::parse("", streams));
+    EXPECT_TRUE(OutputStreams::parse("a:text:0;b:binary:2.5;", streams));
+    EXPECT_EQ(streams.size(), 2u);
+    EXPECT_DOUBLE_EQ(streams[1].rate, 2.5);
+    streams.clear();
+    EXPECT_FALSE(OutputStreams::parse("a:text", streams));
+    streams.clear();
+    EXPECT_FALSE(OutputStreams::parse("a:json:1", streams));
+    streams.clear();
+    EXPECT_FALSE(OutputStreams::parse("a:text:-1", streams));
+    streams.clear();
+    EXPECT_FALSE(OutputStreams::parse("a:text:1x", streams));
+    streams.clear();
+    EXPECT_FALSE(OutputStreams::parse("a:text:1;a:binary:1", streams));
+    streams.clear();
+    EXPECT_FALSE(OutputStreams::parse("a/b:text:1", streams));
+    streams.clear();
+    EXPECT_FALSE(OutputStreams::parse("stats:text:1", streams));
+}
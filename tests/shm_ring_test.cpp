@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include <Eigen/Dense>
+#include <string>
+#include <unistd.h>
+#include "shm_publisher.hpp"
+#include "state_ring.hpp"
+#include "state.hpp"
+#include "params.hpp"
+
+using Result = drop_ring::Reader::Result;
+
+/// Ring name unique for test process
+static std::string ringName(const std::string& test)
+{
+    return "/drop_test_" + test + "_" + std::to_string(getpid());
+}
+
+/// Reader should see published frames in order, without copies
+TEST(ShmRingTest, FramesInOrder) {
+    Params params{};
+    State state;
+    int id = state.addObj(1.0, 0.1, Eigen::Vector3d(1.0,2.0,3.0), Eigen::Vector3d(4.0,5.0,6.0));
+    ShmPublisher ring;
+    ASSERT_TRUE(ring.create(ringName("order"), 4, 16));
+    drop_ring::Reader reader;
+    ASSERT_TRUE(reader.open(ringName("order")));
+    drop_frame::FrameReader frame;
+    EXPECT_EQ(reader.next(frame), Result::empty);
+    for (uint64_t tick = 1; tick <= 3; tick++)
+    {
+        state.tick = tick;
+        ASSERT_TRUE(ring.publish(state));
+    }
+    for (uint64_t tick = 1; tick <= 3; tick++)
+    {
+        ASSERT_EQ(reader.next(frame), Result::ok);
+        EXPECT_EQ(frame.header().tick, tick);
+        ASSERT_EQ(frame.size(), 1u);
+        EXPECT_EQ(frame.at(0).id, id);
+        EXPECT_EQ(frame.at(0).vel[2], 6.0);
+        EXPECT_TRUE(reader.intact(reader.current()));
+    }
+    EXPECT_EQ(reader.next(frame), Result::empty);
+    EXPECT_EQ(reader.lost(), 0u);
+}
+
+/// Reader slower than writer should be told how many frames it lost and continue from latest frame
+TEST(ShmRingTest, SlowReaderOverrun) {
+    Params params{};
+    State state;
+    state.addObj(1.0, 0.1, Eigen::Vector3d::Zero());
+    ShmPublisher ring;
+    ASSERT_TRUE(ring.create(ringName("slow"), 4, 16));
+    drop_ring::Reader reader;
+    ASSERT_TRUE(reader.open(ringName("slow")));
+    drop_frame::FrameReader frame;
+    for (uint64_t tick = 1; tick <= 10; tick++)
+    {
+        state.tick = tick;
+        ring.publish(state);
+    }
+    // frames 1..6 are overwritten
+    ASSERT_EQ(reader.next(frame), Result::overrun);
+    EXPECT_EQ(frame.header().tick, 10u);
+    EXPECT_EQ(reader.lost(), 9u);
+    EXPECT_EQ(reader.next(frame), Result::empty);
+    // overwritten frame can not be read directly either
+    EXPECT_EQ(reader.read(5, frame), Result::overrun);
+    EXPECT_EQ(reader.read(8, frame), Result::ok);
+    EXPECT_EQ(reader.read(11, frame), Result::empty);
+}
+
+/// Frame overwritten while reader used it should be detected
+TEST(ShmRingTest, DetectsTornRead) {
+    Params params{};
+    State state;
+    state.addObj(1.0, 0.1, Eigen::Vector3d::Zero());
+    ShmPublisher ring;
+    ASSERT_TRUE(ring.create(ringName("torn"), 2, 16));
+    drop_ring::Reader reader;
+    ASSERT_TRUE(reader.open(ringName("torn")));
+    drop_frame::FrameReader frame;
+    ring.publish(state);
+    ASSERT_EQ(reader.readLatest(frame), Result::ok);
+    const uint64_t n = reader.current();
+    EXPECT_TRUE(reader.intact(n));
+    ring.publish(state);
+    EXPECT_TRUE(reader.intact(n));
+    ring.publish(state);
+    EXPECT_FALSE(reader.intact(n));
+}
+
+/// Frames larger than slot should be dropped and counted, not truncated
+TEST(ShmRingTest, OversizedFrameDropped) {
+    Params params{};
+    State state;
+    for (int i = 0; i < 3; i++)
+    {
+        state.addObj(1.0, 0.1, Eigen::Vector3d(i,0.0,0.0));
+    }
+    ShmPublisher ring;
+    ASSERT_TRUE(ring.create(ringName("big"), 2, 2));
+    drop_ring::Reader reader;
+    ASSERT_TRUE(reader.open(ringName("big")));
+    EXPECT_FALSE(ring.publish(state));
+    EXPECT_EQ(ring.published(), 0u);
+    EXPECT_EQ(reader.oversized(), 1u);
+    drop_frame::FrameReader frame;
+    EXPECT_EQ(reader.next(frame), Result::empty);
+}
+
+/// Ring should disappear with its writer
+TEST(ShmRingTest, MissingRing) {
+    drop_ring::Reader reader;
+    {
+        ShmPublisher ring;
+        ASSERT_TRUE(ring.create(ringName("gone"), 2, 2));
+    }
+    EXPECT_FALSE(reader.open(ringName("gone")));
+    EXPECT_FALSE(reader.isOpen());
+}
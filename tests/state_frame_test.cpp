@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <Eigen/Dense>
+#include <vector>
+#include "state.hpp"
+#include "params.hpp"
+#include "state_frame.hpp"
+#include "defines.hpp"
+
+/// Binary frame should carry the same objects as state
+TEST(StateFrameTest, FrameRoundTrip) {
+    Params params{};
+    State state;
+    std::vector<int> ids;
+    for (int i = 0; i < 5; i++)
+    {
+        ids.push_back(state.addObj(1.0, 0.1, Eigen::Vector3d(i,2.0*i,3.0*i), Eigen::Vector3d(-i,0.5,1.0)));
+    }
+    state.removeObj(ids[1]);
+    state.real_time = 1.5;
+    state.tick = 500;
+
+    std::vector<char> frame;
+    state.to_frame(frame);
+    drop_frame::FrameReader reader;
+    ASSERT_TRUE(reader.parse(frame.data(), frame.size()));
+    EXPECT_EQ(reader.header().tick, 500u);
+    EXPECT_DOUBLE_EQ(reader.header().time, 1.5);
+    ASSERT_EQ(reader.size(), 4u);
+    for (size_t i = 0; i < reader.size(); i++)
+    {
+        auto record = reader.at(i);
+        int index = state.findIndex(record.id);
+        ASSERT_GE(index, 0);
+        EXPECT_NE(record.id, ids[1]);
+        for (int j = 0; j < 3; j++)
+        {
+            EXPECT_EQ(record.pos[j], state.getPos(index)(j));
+            EXPECT_EQ(record.vel[j], state.getVel(index)(j));
+        }
+    }
+}
+
+/// Reader should reject truncated and foreign data
+TEST(StateFrameTest, RejectsInvalidFrames) {
+    Params params{};
+    State state;
+    state.addObj(1.0, 0.1, Eigen::Vector3d(1.0,2.0,3.0));
+    std::vector<char> frame;
+    state.to_frame(frame);
+    drop_frame::FrameReader reader;
+    EXPECT_FALSE(reader.parse(frame.data(), frame.size() - 1));
+    frame[0] = 'X';
+    EXPECT_FALSE(reader.parse(frame.data(), frame.size()));
+    EXPECT_EQ(reader.size(), 0u);
+}
+
+/// Sleeping objects should be flagged and published only from time to time
+TEST(StateFrameTest, SleepingObjectsPublishedSparsely) {
+    Params params{};
+    State state;
+    int awake = state.addObj(1.0, 0.1, Eigen::Vector3d(0.0,0.0,0.0));
+    int sleeping = state.addObj(1.0, 0.1, Eigen::Vector3d(1.0,0.0,0.0));
+    state.tick = 1;
+    state.sleep(state.findIndex(sleeping));
+    std::vector<char> frame;
+    drop_frame::FrameReader reader;
+
+    state.to_frame(frame);
+    ASSERT_TRUE(reader.parse(frame.data(), frame.size()));
+    ASSERT_EQ(reader.size(), 2u);
+    for (size_t i = 0; i < reader.size(); i++)
+    {
+        EXPECT_EQ(reader.at(i).flags, reader.at(i).id == sleeping ? drop_frame::FLAG_SLEEPING : 0u);
+    }
+
+    state.tick = 2;
+    state.to_frame(frame);
+    ASSERT_TRUE(reader.parse(frame.data(), frame.size()));
+    ASSERT_EQ(reader.size(), 1u);
+    EXPECT_EQ(reader.at(0).id, awake);
+
+    state.tick = def::SLEEP_PUBLISH_INTERVAL;
+    state.to_frame(frame);
+    ASSERT_TRUE(reader.parse(frame.data(), frame.size()));
+    EXPECT_EQ(reader.size(), 2u);
+}
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <Eigen/Dense>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+#include "terrain.hpp"
+#include "engine.hpp"
+#include "params.hpp"
+
+namespace fs = std::filesystem;
+
+/// Write 2x2 tiles of 4x4 samples with 2 m cell, first sample at (-4,-4)
+/// @return path of index file
+static std::string writeTerrain(const std::string& name, const std::function<float(double,double)>& elevation,
+    const std::string& extra = "")
+{
+    const fs::path dir = fs::temp_directory_path() / name;
+    fs::create_directories(dir);
+    const int side = 4;
+    const double cell = 2.0, origin = -4.0;
+    for (int ix = 0; ix < 2; ix++)
+    {
+        for (int iy = 0; iy < 2; iy++)
+        {
+            std::vector<float> data(side*side);
+            for (int r = 0; r < side; r++)
+            {
+                for (int c = 0; c < side; c++)
+                {
+                    data[r*side + c] = elevation(origin + (ix*side + c)*cell, origin + (iy*side + r)*cell);
+                }
+            }
+            std::ofstream tile(dir / ("tile_" + std::to_string(ix) + "_" + std::to_string(iy) + ".raw"), std::ios::binary);
+            tile.write(reinterpret_cast<const char*>(data.data()), data.size()*sizeof(float));
+        }
+    }
+    std::ofstream index(dir / "terrain.txt");
+    index << "# test terrain\noriginX=-4\noriginY=-4\ncell=2\ntileSize=4\ntilesX=2\ntilesY=2\n"
+        << "COR=0.5\nmiStatic=0.2\nmiDynamic=0.1\n" << extra;
+    return (dir / "terrain.txt").string();
+}
+
+/// Plane should be reproduced exactly by bilinear interpolation, also across tile borders
+TEST(TerrainTest, ElevationAcrossTiles) {
+    Terrain terrain;
+    ASSERT_TRUE(terrain.load(writeTerrain("drop_terrain_plane",
+        [](double x, double y) {return 10.0 + 0.5*x + 0.25*y;}, "material=1,0,0.9,0.8,0.7\n")));
+    for(auto [x,y]: {std::pair{0.0,0.0}, {3.3,-2.1}, {3.9,4.0}, {-4.0,-4.0}, {10.0,10.0}, {7.5,1.0}})
+    {
+        EXPECT_NEAR(terrain.elevation(x,y), 10.0 + 0.5*x + 0.25*y, 1e-5) << x << "," << y;
+    }
+    EXPECT_TRUE(std::isnan(terrain.elevation(-4.1,0.0)));
+    EXPECT_TRUE(std::isnan(terrain.elevation(0.0,10.1)));
+    EXPECT_DOUBLE_EQ(terrain.material(-1.0,-1.0).COR, 0.5);
+    EXPECT_DOUBLE_EQ(terrain.material(5.0,-1.0).COR, 0.9);
+    EXPECT_DOUBLE_EQ(terrain.material(5.0,-1.0).mi_dynamic, 0.7);
+}
+
+/// Sweep should find entry point on surface, also for fast horizontal flight into slope
+TEST(TerrainTest, SweepFindsEntry) {
+    Terrain terrain;
+    ASSERT_TRUE(terrain.load(writeTerrain("drop_terrain_slope",
+        [](double x, double) {return 2.0*x;})));
+    Terrain::Hit hit;
+    EXPECT_FALSE(terrain.sweep(Eigen::Vector3d(0.0,0.0,-5.0), Eigen::Vector3d(0.0,0.0,-1.0), hit));
+    ASSERT_TRUE(terrain.sweep(Eigen::Vector3d(0.0,0.0,-5.0), Eigen::Vector3d(0.0,0.0,5.0), hit));
+    EXPECT_NEAR(hit.pos.z(), 0.0, 1e-6);
+    // both ends above ground, segment crosses hill in between
+    ASSERT_TRUE(terrain.sweep(Eigen::Vector3d(-3.0,0.0,-8.0), Eigen::Vector3d(10.0,0.0,-8.0), hit));
+    EXPECT_NEAR(hit.pos.x(), 4.0, 1e-6);
+    EXPECT_NEAR(hit.pos.z(), -8.0, 1e-6);
+    const Eigen::Vector3d expected = Eigen::Vector3d(-2.0,0.0,-1.0).normalized();
+    EXPECT_NEAR((hit.normal - expected).norm(), 0.0, 1e-6);
+    // outside terrain there is no ground
+    EXPECT_FALSE(terrain.sweep(Eigen::Vector3d(20.0,0.0,-5.0), Eigen::Vector3d(20.0,0.0,50.0), hit));
+}
+
+/// Falling object should bounce on terrain and never go below it
+TEST(TerrainTest, EngineBouncesOnGround) {
+    Params params{};
+    params.TERRAIN = writeTerrain("drop_terrain_flat", [](double, double) {return 10.0;});
+    Engine engine(params);
+    ASSERT_TRUE(engine.valid());
+    State& state = engine.getState();
+    int id = engine.addObj(1.0, 0.0, Eigen::Vector3d(0.0,0.0,-30.0), Eigen::Vector3d(1.0,0.0,0.0));
+    bool bounced = false;
+    for (int i = 0; i < 1000; i++)
+    {
+        engine.step();
+        int index = state.findIndex(id);
+        ASSERT_LE(state.getPos(index).z(), -10.0 + 1e-6) << "step " << i;
+        bounced = bounced || state.getVel(index).z() < -1.0;
+    }
+    EXPECT_TRUE(bounced);
+}
+
+/// Engine should not run with terrain that can not be loaded
+TEST(TerrainTest, InvalidTerrainMakesEngineInvalid) {
+    Params params{};
+    params.TERRAIN = (fs::temp_directory_path() / "drop_terrain_missing" / "terrain.txt").string();
+    Engine engine(params);
+    EXPECT_FALSE(engine.valid());
+}
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <vector>
+#include "thread_pool.hpp"
+
+/// Every task should run exactly once, also when pool is reused
+TEST(ThreadPoolTest, EveryTaskRunsOnce) {
+    ThreadPool pool(4);
+    EXPECT_EQ(pool.size(), 4);
+    for (int tasks: {0, 1, 3, 4, 100, 1001})
+    {
+        std::vector<std::atomic_int> runs(tasks);
+        auto task = [&](int i) {runs[i].fetch_add(1);};
+        pool.parallelFor(tasks,task);
+        for (int i = 0; i < tasks; i++)
+        {
+            ASSERT_EQ(runs[i].load(), 1) << "task " << i << " of " << tasks;
+        }
+    }
+}
+
+/// Unbalanced tasks should be stolen by idle threads
+TEST(ThreadPoolTest, IdleThreadsStealWork) {
+    ThreadPool pool(2);
+    std::atomic_bool released{false};
+    std::atomic_int finished{0};
+    // first half belongs to calling thread, first task blocks until second thread takes rest of work
+    auto task = [&](int i)
+    {
+        if(i == 0)
+        {
+            while(finished.load() < 3) std::this_thread::yield();
+            released = true;
+        }
+        else
+        {
+            finished.fetch_add(1);
+        }
+    };
+    pool.parallelFor(4,task);
+    EXPECT_TRUE(released.load());
+    EXPECT_EQ(finished.load(), 3);
+}
+
+/// Single thread pool should run tasks on calling thread
+TEST(ThreadPoolTest, SingleThreadRunsInline) {
+    ThreadPool pool(1);
+    const auto caller = std::this_thread::get_id();
+    int sum = 0;
+    auto task = [&](int i)
+    {
+        EXPECT_EQ(std::this_thread::get_id(), caller);
+        sum += i;
+    };
+    pool.parallelFor(10,task);
+    EXPECT_EQ(sum, 45);
+}
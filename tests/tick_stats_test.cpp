@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include "tick_stats.hpp"
+
+/// Every value should fall into bucket whose bounds contain it, with bounded relative error
+TEST(TickStatsTest, HistogramBuckets) {
+    int previous = -1;
+    for (uint64_t ns = 0; ns < (1ull << 36); ns = ns < 64 ? ns + 1 : ns + ns/7)
+    {
+        const int bucket = LatencyHistogram::bucket(ns);
+        ASSERT_GE(bucket, previous);
+        ASSERT_LT(bucket, LatencyHistogram::BUCKETS);
+        const uint64_t upper = LatencyHistogram::upperBound(bucket);
+        ASSERT_GE(upper, ns);
+        ASSERT_LE(upper - ns, ns/16 + 1) << ns;
+        previous = bucket;
+    }
+}
+
+/// Quantiles of uniform samples should be close to exact ones
+TEST(TickStatsTest, HistogramQuantiles) {
+    LatencyHistogram h;
+    EXPECT_EQ(h.quantile(0.5), 0u);
+    for (uint64_t ns = 1; ns <= 100000; ns++)
+    {
+        h.record(ns);
+    }
+    EXPECT_EQ(h.count(), 100000u);
+    EXPECT_EQ(h.max(), 100000u);
+    EXPECT_NEAR(h.quantile(0.5), 50000.0, 50000.0/16);
+    EXPECT_NEAR(h.quantile(0.99), 99000.0, 99000.0/16);
+    EXPECT_EQ(h.quantile(1.0), 100000u);
+}
+
+/// Ticks longer than budget should be counted and reported with queue depth
+TEST(TickStatsTest, CountsOverrunsAndReports) {
+    TickStats stats(0.001);
+    stats.begin();
+    stats.lap(TickStats::commands);
+    stats.end(3);
+    stats.begin();
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    stats.lap(TickStats::integration);
+    stats.end(1);
+    EXPECT_EQ(stats.getOverruns(), 1u);
+    EXPECT_EQ(stats.getMaxQueueDepth(), 3);
+    EXPECT_GE(stats.getPhase(TickStats::integration).max(), 2000000u);
+    EXPECT_EQ(stats.getPhase(TickStats::tick).count(), 2u);
+    const std::string report = stats.report();
+    EXPECT_EQ(report.substr(0, report.find('\n')), "ticks=2;overruns=1;queue=1,3");
+    EXPECT_NE(report.find("\nintegration="), std::string::npos);
+    EXPECT_NE(report.find("\nprediction="), std::string::npos);
+    EXPECT_EQ(report.find("\nlog="), std::string::npos);
+}
+
+/// Attached logger counters should be reported
+TEST(TickStatsTest, ReportsLogger) {
+    TickStats stats(0.001);
+    AsyncLogger logger(OverflowPolicy::drop, 2);
+    const double sample[6] = {};
+    for (int i = 0; i < 1000; i++)
+    {
+        logger.logState(0.0, i, 0, sample);
+    }
+    stats.attachLogger(logger);
+    const std::string report = stats.report();
+    const size_t pos = report.find("\nlog=");
+    ASSERT_NE(pos, std::string::npos);
+    const std::string counters = report.substr(pos + 5);
+    EXPECT_EQ(std::stoull(counters.substr(counters.find(',') + 1)), logger.getDropped());
+}
+
+/// Instrumentation of whole tick should cost far less than 1% of 3 ms tick
+TEST(TickStatsTest, LowOverhead) {
+    TickStats stats(0.003);
+    const int ticks = 100000;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ticks; i++)
+    {
+        stats.begin();
+        for (int phase = 0; phase < TickStats::tick; phase++)
+        {
+            stats.lap(static_cast<TickStats::Phase>(phase));
+        }
+        stats.end(0);
+    }
+    const double perTick = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()/ticks;
+    EXPECT_LT(perTick, 0.01*0.003);
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <Eigen/Dense>
+#include <map>
+#include <string>
+#include <vector>
+#include "topic_publisher.hpp"
+#include "state.hpp"
+#include "params.hpp"
+#include "defines.hpp"
+#include "projectile_parser.hpp"
+
+/// Messages of last update by topic
+static std::map<std::string,std::string> byTopic(const TopicPublisher& topics)
+{
+    std::map<std::string,std::string> messages;
+    for (size_t i = 0; i < topics.size(); i++)
+    {
+        messages[topics.at(i).topic] = topics.at(i).payload;
+    }
+    return messages;
+}
+
+/// Without delta every object should get own topic and region topic should carry objects inside it
+TEST(TopicPublisherTest, ObjectAndRegionTopics) {
+    Params params{};
+    State state;
+    int a = state.addObj(1.0, 0.1, Eigen::Vector3d(1.0,1.0,-1.0), Eigen::Vector3d(2.0,0.0,0.0));
+    int b = state.addObj(1.0, 0.1, Eigen::Vector3d(50.0,0.0,-1.0));
+    state.real_time = 0.5;
+    state.tick = 7;
+    TopicPublisher topics("box,0,0,-10,10,10,0;far,100,100,-10,200,200,0", 0.0);
+    ASSERT_TRUE(topics.valid());
+    topics.update(state);
+    auto messages = byTopic(topics);
+    EXPECT_EQ(topics.at(0).topic, "t|");
+    EXPECT_EQ(messages["t|"], "7;0.500000;key;");
+    ASSERT_EQ(messages.size(), 5u);
+    // payloads have format of full state
+    auto [time, objects] = parseInput(messages["o/" + std::to_string(a) + "|"]);
+    EXPECT_DOUBLE_EQ(time, 0.5);
+    ASSERT_EQ(objects.size(), 1u);
+    EXPECT_EQ(objects[0].id, a);
+    EXPECT_EQ(objects[0].velocity.x(), 2.0);
+    auto [boxTime, inBox] = parseInput(messages["r/box|"]);
+    ASSERT_EQ(inBox.size(), 1u);
+    EXPECT_EQ(inBox[0].id, a);
+    EXPECT_EQ(messages["r/far|"], "0.500000;");
+    EXPECT_EQ(messages.count("o/" + std::to_string(b) + "|"), 1u);
+}
+
+/// With delta only objects that moved enough should be sent, with keyframes and removals
+TEST(TopicPublisherTest, DeltaAndKeyframes) {
+    Params params{};
+    State state;
+    int still = state.addObj(1.0, 0.1, Eigen::Vector3d(0.0,0.0,-1.0));
+    int moving = state.addObj(1.0, 0.1, Eigen::Vector3d(5.0,0.0,-1.0));
+    TopicPublisher topics("", 0.5);
+    topics.update(state);
+    EXPECT_EQ(topics.size(), 3u);
+    EXPECT_NE(topics.at(0).payload.find(";key;"), std::string::npos);
+
+    state.setPos(state.findIndex(moving), Eigen::Vector3d(5.3,0.0,-1.0));
+    topics.update(state);
+    EXPECT_EQ(topics.size(), 1u);
+    EXPECT_NE(topics.at(0).payload.find(";delta;"), std::string::npos);
+    // change is measured from last sent state, so small steps add up
+    state.setPos(state.findIndex(moving), Eigen::Vector3d(5.6,0.0,-1.0));
+    topics.update(state);
+    ASSERT_EQ(topics.size(), 2u);
+    EXPECT_EQ(topics.at(1).topic, "o/" + std::to_string(moving) + "|");
+
+    state.removeObj(moving);
+    topics.update(state);
+    ASSERT_EQ(topics.size(), 1u);
+    EXPECT_EQ(topics.at(0).payload.substr(topics.at(0).payload.rfind(';') + 1), std::to_string(moving));
+
+    for (int i = 4; i < def::KEYFRAME_INTERVAL; i++)
+    {
+        topics.update(state);
+        EXPECT_EQ(topics.size(), 1u);
+    }
+    topics.update(state);
+    ASSERT_EQ(topics.size(), 2u);
+    EXPECT_NE(topics.at(0).payload.find(";key;"), std::string::npos);
+    EXPECT_EQ(topics.at(1).topic, "o/" + std::to_string(still) + "|");
+}
+
+/// Invalid regions should be rejected
+TEST(TopicPublisherTest, InvalidRegions) {
+    std::vector<TopicPublisher::Region> regions;
+    EXPECT_TRUE(TopicPublisher::parseRegions("", regions));
+    EXPECT_TRUE(TopicPublisher::parseRegions("a,0,0,0,1,1,1;", regions));
+    EXPECT_EQ(regions.size(), 1u);
+    EXPECT_FALSE(TopicPublisher::parseRegions("a,0,0,0,1,1", regions));
+    EXPECT_FALSE(TopicPublisher::parseRegions("a,0,0,0,1,1,1,1", regions));
+    EXPECT_FALSE(TopicPublisher::parseRegions("a,1,0,0,0,1,1", regions));
+    EXPECT_FALSE(TopicPublisher::parseRegions("a|b,0,0,0,1,1,1", regions));
+    EXPECT_FALSE(TopicPublisher::parseRegions(",0,0,0,1,1,1", regions));
+    EXPECT_FALSE(TopicPublisher("a,x,0,0,1,1,1", 0.0).valid());
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include <Eigen/Dense>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+#include "wind_field.hpp"
+#include "engine.hpp"
+#include "params.hpp"
+
+namespace fs = std::filesystem;
+
+/// Write 5x5x6 grid with 5x5x4 m cells in 3 slices 10 s apart, first node at (-10,-10,-20)
+/// @return path of field file
+static std::string writeField(const std::string& name,
+    const std::function<Eigen::Vector3d(const Eigen::Vector3d&,double)>& wind)
+{
+    WindField::Grid grid;
+    grid.nx = 5;
+    grid.ny = 5;
+    grid.nz = 6;
+    grid.nt = 3;
+    grid.origin = Eigen::Vector3d(-10.0,-10.0,-20.0);
+    grid.spacing = Eigen::Vector3d(5.0,5.0,4.0);
+    grid.t0 = 0.0;
+    grid.dt = 10.0;
+    std::vector<float> data;
+    for (int t = 0; t < grid.nt; t++)
+        for (int k = 0; k < grid.nz; k++)
+            for (int j = 0; j < grid.ny; j++)
+                for (int i = 0; i < grid.nx; i++)
+                {
+                    const Eigen::Vector3d pos = grid.origin + grid.spacing.cwiseProduct(Eigen::Vector3d(i,j,k));
+                    const Eigen::Vector3d w = wind(pos, grid.t0 + t*grid.dt);
+                    data.insert(data.end(), {static_cast<float>(w.x()), static_cast<float>(w.y()), static_cast<float>(w.z())});
+                }
+    const std::string path = (fs::temp_directory_path() / name).string();
+    EXPECT_TRUE(WindField::save(path, grid, data));
+    return path;
+}
+
+static Eigen::Vector3d linear(const Eigen::Vector3d& pos, double t)
+{
+    return Eigen::Vector3d(1.0 + 0.5*pos.x(), -0.25*pos.y() + 0.1*t, 2.0 + 0.2*pos.z());
+}
+
+/// Linear field should be reproduced exactly by trilinear and temporal interpolation
+TEST(WindFieldTest, InterpolatesLinearField) {
+    WindField field;
+    ASSERT_TRUE(field.load(writeField("drop_wind_linear.dwf", linear)));
+    EXPECT_EQ(field.getGrid().nz, 6);
+    for(double t: {0.0, 3.0, 10.0, 17.5, 20.0})
+    {
+        const WindField::Frame frame = field.at(t);
+        for(const Eigen::Vector3d& pos: {Eigen::Vector3d(0.0,0.0,0.0), Eigen::Vector3d(-10.0,-10.0,-20.0),
+            Eigen::Vector3d(10.0,10.0,0.0), Eigen::Vector3d(3.3,-7.1,-13.9), Eigen::Vector3d(9.9,2.5,-0.1)})
+        {
+            EXPECT_NEAR((frame(pos) - linear(pos,t)).norm(), 0.0, 1e-5) << pos.transpose() << " t=" << t;
+        }
+    }
+}
+
+/// Outside grid and time range nearest boundary value should be used
+TEST(WindFieldTest, ClampsToGrid) {
+    WindField field;
+    ASSERT_TRUE(field.load(writeField("drop_wind_clamp.dwf", linear)));
+    const WindField::Frame late = field.at(100.0);
+    EXPECT_NEAR((late(Eigen::Vector3d(50.0,0.0,-30.0)) - linear(Eigen::Vector3d(10.0,0.0,-20.0),20.0)).norm(), 0.0, 1e-5);
+    const WindField::Frame early = field.at(-5.0);
+    EXPECT_NEAR((early(Eigen::Vector3d(0.0,-50.0,10.0)) - linear(Eigen::Vector3d(0.0,-10.0,0.0),0.0)).norm(), 0.0, 1e-5);
+}
+
+/// Not finite position or time should give value of grid node instead of undefined behaviour
+TEST(WindFieldTest, NotFiniteInputsStayInGrid) {
+    WindField field;
+    ASSERT_TRUE(field.load(writeField("drop_wind_nan.dwf", linear)));
+    const double nan = std::numeric_limits<double>::quiet_NaN(), inf = std::numeric_limits<double>::infinity();
+    const WindField::Frame frame = field.at(0.0);
+    EXPECT_NEAR((frame(Eigen::Vector3d(nan,nan,nan)) - linear(Eigen::Vector3d(-10.0,-10.0,-20.0),0.0)).norm(), 0.0, 1e-5);
+    EXPECT_NEAR((frame(Eigen::Vector3d(inf,-inf,1e300)) - linear(Eigen::Vector3d(10.0,-10.0,0.0),0.0)).norm(), 0.0, 1e-5);
+    EXPECT_TRUE(field.at(nan)(Eigen::Vector3d::Zero()).allFinite());
+}
+
+/// Truncated or foreign files should be rejected
+TEST(WindFieldTest, RejectsInvalidFile) {
+    WindField field;
+    const fs::path path = fs::temp_directory_path() / "drop_wind_invalid.dwf";
+    std::ofstream(path, std::ios::binary) << "DWF1 definitely not a wind field";
+    EXPECT_FALSE(field.load(path.string()));
+    EXPECT_FALSE(field.loaded());
+    EXPECT_FALSE(field.load((fs::temp_directory_path() / "drop_wind_missing.dwf").string()));
+    WindField::Grid grid;
+    grid.nx = grid.ny = grid.nz = grid.nt = 1;
+    grid.spacing.x() = std::numeric_limits<double>::quiet_NaN();
+    ASSERT_TRUE(WindField::save(path.string(), grid, {1.0f, 2.0f, 3.0f}));
+    EXPECT_FALSE(field.load(path.string()));
+    // dimensions whose product overflows must not pass size check
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    const uint32_t dims[5] = {1u << 16, 1u << 16, 1u << 16, 1u << 16, 0};
+    const double values[8] = {0.0, 0.0, 0.0, 1.0, 1.0, 1.0, 0.0, 1.0};
+    out.write("DWF1", 4);
+    out.write(reinterpret_cast<const char*>(dims), sizeof(dims));
+    out.write(reinterpret_cast<const char*>(values), sizeof(values));
+    out.write(std::string(64, '\0').data(), 64);
+    out.close();
+    EXPECT_FALSE(field.load(path.string()));
+}
+
+/// Objects should be blown by field unless their wind was set by message
+TEST(WindFieldTest, EngineUsesFieldAndOverride) {
+    Params params{};
+    params.WIND_FIELD = writeField("drop_wind_uniform.dwf",
+        [](const Eigen::Vector3d&, double) {return Eigen::Vector3d(5.0,0.0,0.0);});
+    Engine engine(params);
+    ASSERT_TRUE(engine.valid());
+    State& state = engine.getState();
+    int blown = engine.addObj(1.0, 1.0, Eigen::Vector3d(0.0,0.0,-10.0), Eigen::Vector3d::Zero());
+    int own = engine.addObj(1.0, 1.0, Eigen::Vector3d(0.0,0.0,-10.0), Eigen::Vector3d::Zero());
+    state.updateWind(own, Eigen::Vector3d(-5.0,0.0,0.0));
+    for (int i = 0; i < 100; i++)
+    {
+        engine.step();
+    }
+    EXPECT_GT(state.getVel(state.findIndex(blown)).x(), 0.1);
+    EXPECT_LT(state.getVel(state.findIndex(own)).x(), -0.1);
+
+    // object without own wind follows field again
+    engine.apply(cmd::Wind{own, Eigen::Vector3d::Zero(), true});
+    EXPECT_FALSE(state.getParams(state.findIndex(own))->hasWind());
+    for (int i = 0; i < 300; i++)
+    {
+        engine.step();
+    }
+    EXPECT_GT(state.getVel(state.findIndex(own)).x(), 0.1);
+}
+
+/// Engine should not run with wind field that can not be loaded
+TEST(WindFieldTest, InvalidFieldMakesEngineInvalid) {
+    Params params{};
+    params.WIND_FIELD = (fs::temp_directory_path() / "drop_wind_missing.dwf").string();
+    Engine engine(params);
+    EXPECT_FALSE(engine.valid());
+}